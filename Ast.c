@@ -0,0 +1,112 @@
+#include "Ast.h"
+
+void Ast_Init(Ast* ast, Arena* arena, U32 expected_nodes) {
+	AstNodeVec_InitArena(&ast->nodes, arena);
+	AstExtraVec_InitArena(&ast->extra, arena);
+	AstNodeVec_Reserve(&ast->nodes, expected_nodes);
+	/* lists are a fraction of the nodes, most of them are argument and statement lists */
+	AstExtraVec_Reserve(&ast->extra, expected_nodes / 4);
+}
+
+static const StrView AstKindPrintTable[AST_KIND_COUNT] = {
+	[AST_FILE] = STRVIEW_INIT("FILE"),
+	[AST_FUNC] = STRVIEW_INIT("FUNC"),
+	[AST_PARAM] = STRVIEW_INIT("PARAM"),
+	[AST_BLOCK] = STRVIEW_INIT("BLOCK"),
+	[AST_IF] = STRVIEW_INIT("IF"),
+	[AST_WHILE] = STRVIEW_INIT("WHILE"),
+	[AST_FOR] = STRVIEW_INIT("FOR"),
+	[AST_ASSIGN] = STRVIEW_INIT("ASSIGN"),
+	[AST_BINARY] = STRVIEW_INIT("BINARY"),
+	[AST_NEGATE] = STRVIEW_INIT("NEGATE"),
+	[AST_CALL] = STRVIEW_INIT("CALL"),
+	[AST_IDENTIFIER] = STRVIEW_INIT("IDENTIFIER"),
+	[AST_NUMBER] = STRVIEW_INIT("NUMBER"),
+	[AST_FLOAT] = STRVIEW_INIT("FLOAT"),
+	[AST_STRING] = STRVIEW_INIT("STRING"),
+	[AST_CHAR] = STRVIEW_INIT("CHAR"),
+	[AST_ERROR] = STRVIEW_INIT("ERROR"),
+};
+
+StrView AstKindToString(AstKind kind) {
+	return AstKindPrintTable[kind];
+}
+
+static void AstPrintNode(const Ast* ast, const TokenBuffer* tokens, Output* out, U32 index, U32 depth);
+
+static void AstPrintRange(const Ast* ast, const TokenBuffer* tokens, Output* out, U32 first, U32 end, U32 depth) {
+	for (U32 i = first; i < end; i++) {
+		AstPrintNode(ast, tokens, out, ast->extra.data[i], depth);
+	}
+}
+
+static void AstPrintChild(const Ast* ast, const TokenBuffer* tokens, Output* out, U32 index, U32 depth) {
+	if (index != AST_NULL) AstPrintNode(ast, tokens, out, index, depth);
+}
+
+static void AstPrintNode(const Ast* ast, const TokenBuffer* tokens, Output* out, U32 index, U32 depth) {
+	const AstNode* node = Ast_GetNode(ast, index);
+	const U32* extra = ast->extra.data;
+
+	for (U32 i = 0; i < depth; i++) Output_WriteStrView(out, STRVIEW("  "));
+	Output_WriteStrView(out, AstKindPrintTable[node->kind]);
+
+	/* nodes named by their token print its text */
+	switch (node->kind) {
+		case AST_FUNC:
+		case AST_PARAM:
+		case AST_BINARY:
+		case AST_IDENTIFIER:
+		case AST_NUMBER:
+		case AST_FLOAT:
+		case AST_STRING:
+		case AST_CHAR:
+			Output_WriteChar(out, ' ');
+			Output_WriteStrView(out, TokenBuffer_GetText(tokens, node->token));
+			break;
+	}
+	Output_WriteChar(out, '\n');
+
+	depth++;
+	switch (node->kind) {
+		case AST_FILE:
+		case AST_BLOCK:
+			AstPrintRange(ast, tokens, out, node->lhs, node->rhs, depth);
+			break;
+		case AST_FUNC:
+			AstPrintRange(ast, tokens, out, extra[node->lhs], extra[node->lhs + 1], depth);
+			AstPrintChild(ast, tokens, out, extra[node->lhs + 2], depth);
+			AstPrintNode(ast, tokens, out, node->rhs, depth);
+			break;
+		case AST_PARAM:
+		case AST_NEGATE:
+			AstPrintChild(ast, tokens, out, node->lhs, depth);
+			break;
+		case AST_IF:
+			AstPrintNode(ast, tokens, out, node->lhs, depth);
+			AstPrintNode(ast, tokens, out, extra[node->rhs], depth);
+			AstPrintChild(ast, tokens, out, extra[node->rhs + 1], depth);
+			break;
+		case AST_FOR:
+			AstPrintChild(ast, tokens, out, extra[node->lhs], depth);
+			AstPrintChild(ast, tokens, out, extra[node->lhs + 1], depth);
+			AstPrintChild(ast, tokens, out, extra[node->lhs + 2], depth);
+			AstPrintNode(ast, tokens, out, node->rhs, depth);
+			break;
+		case AST_WHILE:
+		case AST_ASSIGN:
+		case AST_BINARY:
+			AstPrintNode(ast, tokens, out, node->lhs, depth);
+			AstPrintNode(ast, tokens, out, node->rhs, depth);
+			break;
+		case AST_CALL:
+			AstPrintNode(ast, tokens, out, node->lhs, depth);
+			AstPrintRange(ast, tokens, out, extra[node->rhs], extra[node->rhs + 1], depth);
+			break;
+	}
+}
+
+void Ast_Print(const Ast* ast, const TokenBuffer* tokens, Output* out) {
+	if (ast->nodes.count == 0) return;
+	AstPrintNode(ast, tokens, out, 0, 0);
+}
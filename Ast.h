@@ -0,0 +1,101 @@
+#pragma once
+#include "Common.h"
+#include "Memory.h"
+#include "Vec.h"
+#include "Token.h"
+#include "Intern.h"
+#include "Output.h"
+
+/*
+	The syntax tree is one flat array of fixed-size nodes. Children are 32-bit
+	indices into that array, nodes with more than two children or a list of
+	them keep the rest in extra, a side table of U32s. Both live in the
+	compilation's arena and contain no pointers, so the whole tree can be
+	copied, cached or written out as is.
+
+	nodes[0] is always the AST_FILE root. Nothing can point back at the root,
+	so AST_NULL (0) in a child slot means "no child".
+
+	What lhs and rhs hold, per kind ([a, b) is a range of extra):
+	AST_FILE        lhs, rhs    [lhs, rhs) top-level statements
+	AST_FUNC        lhs         extra[lhs] = first param, extra[lhs + 1] = end of the params in extra
+	                            extra[lhs + 2] = return type identifier or AST_NULL
+	                rhs         body block
+	                token       the name
+	AST_PARAM       lhs         type identifier or AST_NULL, token is the name
+	AST_BLOCK       lhs, rhs    [lhs, rhs) statements
+	AST_IF          lhs         condition
+	                rhs         extra[rhs] = then block, extra[rhs + 1] = else block, AST_IF or AST_NULL
+	AST_WHILE       lhs, rhs    condition, body
+	AST_FOR         lhs         extra[lhs .. lhs + 2] = init, condition, step, each may be AST_NULL
+	                rhs         body
+	AST_ASSIGN      lhs, rhs    target, value
+	AST_BINARY      lhs, rhs    operands, op is the operator's TokenKind
+	AST_NEGATE      lhs         operand
+	AST_CALL        lhs         callee
+	                rhs         extra[rhs] = first argument, extra[rhs + 1] = end of the arguments in extra
+	AST_IDENTIFIER  lhs         interned symbol
+	AST_NUMBER      lhs         index of the value in the interner's constants, token is the literal
+	AST_FLOAT       lhs         same, the constant holds the double's bits
+	AST_STRING                  token is the literal, quotes and escapes included
+	AST_CHAR        lhs         the character, token is the literal
+	AST_ERROR                   stands in for whatever didn't parse, token is where it went wrong
+*/
+#define AST_NULL 0
+
+typedef enum {
+	AST_FILE,
+	AST_FUNC,
+	AST_PARAM,
+	AST_BLOCK,
+	AST_IF,
+	AST_WHILE,
+	AST_FOR,
+	AST_ASSIGN,
+	AST_BINARY,
+	AST_NEGATE,
+	AST_CALL,
+	AST_IDENTIFIER,
+	AST_NUMBER,
+	AST_FLOAT,
+	AST_STRING,
+	AST_CHAR,
+	AST_ERROR,
+	AST_KIND_COUNT
+} AstKind;
+
+/* 16 bytes, four to a cache line */
+typedef struct astnode_t {
+	U8 kind;
+	U8 op;
+	U16 reserved;
+	U32 token;              // index of the node's main token in the file's TokenBuffer
+	U32 lhs;
+	U32 rhs;
+} AstNode;
+
+DEFINE_VEC(AstNode)
+DEFINE_VEC_NAMED(AstExtraVec, U32)
+
+typedef struct ast_t {
+	AstNodeVec nodes;
+	AstExtraVec extra;
+} Ast;
+
+/* Storage comes from arena, expected_nodes sizes it up front */
+void Ast_Init(Ast* ast, Arena* arena, U32 expected_nodes);
+
+static inline U32 Ast_AddNode(Ast* ast, AstKind kind, U32 token, U32 lhs, U32 rhs) {
+	U32 index = ast->nodes.count;
+	AstNodeVec_Push(&ast->nodes, (AstNode) {.kind= (U8)kind, .token= token, .lhs= lhs, .rhs= rhs});
+	return index;
+}
+
+static inline const AstNode* Ast_GetNode(const Ast* ast, U32 index) {
+	return &ast->nodes.data[index];
+}
+
+StrView AstKindToString(AstKind kind);
+
+/* One node per line, indented by depth */
+void Ast_Print(const Ast* ast, const TokenBuffer* tokens, Output* out);
@@ -0,0 +1,116 @@
+#pragma once
+#include "Common.h"
+
+/*
+	Minimal atomics over the compiler intrinsics. Loads acquire, stores release
+	and read-modify-write operations are sequentially consistent unless their
+	name says otherwise (Relaxed is for counters nobody synchronizes on).
+*/
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+static __inline U32 Atomic_LoadU32(volatile U32* ptr) {
+	U32 value = *ptr;
+	_ReadWriteBarrier();
+	return value;
+}
+
+static __inline void Atomic_StoreU32(volatile U32* ptr, U32 value) {
+	_ReadWriteBarrier();
+	*ptr = value;
+}
+
+static __inline U32 Atomic_AddU32(volatile U32* ptr, U32 value) {
+	return (U32)_InterlockedExchangeAdd((volatile long*)ptr, (long)value) + value;
+}
+
+static __inline Bool Atomic_CompareExchangeU32(volatile U32* ptr, U32 expected, U32 desired) {
+	return (U32)_InterlockedCompareExchange((volatile long*)ptr, (long)desired, (long)expected) == expected;
+}
+
+static __inline U64 Atomic_LoadU64(volatile U64* ptr) {
+	U64 value = *ptr;
+	_ReadWriteBarrier();
+	return value;
+}
+
+static __inline void Atomic_StoreU64(volatile U64* ptr, U64 value) {
+	_ReadWriteBarrier();
+	*ptr = value;
+}
+
+static __inline U64 Atomic_AddRelaxedU64(volatile U64* ptr, U64 value) {
+	return (U64)_InterlockedExchangeAdd64((volatile long long*)ptr, (long long)value) + value;
+}
+
+static __inline Bool Atomic_CompareExchangeU64(volatile U64* ptr, U64 expected, U64 desired) {
+	return (U64)_InterlockedCompareExchange64((volatile long long*)ptr, (long long)desired, (long long)expected) == expected;
+}
+
+#define Atomic_Pause() _mm_pause()
+#define Atomic_Fence() _mm_mfence()
+
+#else
+
+static inline U32 Atomic_LoadU32(volatile U32* ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void Atomic_StoreU32(volatile U32* ptr, U32 value) {
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline U32 Atomic_AddU32(volatile U32* ptr, U32 value) {
+	return __atomic_add_fetch(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+static inline Bool Atomic_CompareExchangeU32(volatile U32* ptr, U32 expected, U32 desired) {
+	return __atomic_compare_exchange_n(ptr, &expected, desired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline U64 Atomic_LoadU64(volatile U64* ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void Atomic_StoreU64(volatile U64* ptr, U64 value) {
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline U64 Atomic_AddRelaxedU64(volatile U64* ptr, U64 value) {
+	return __atomic_add_fetch(ptr, value, __ATOMIC_RELAXED);
+}
+
+static inline Bool Atomic_CompareExchangeU64(volatile U64* ptr, U64 expected, U64 desired) {
+	return __atomic_compare_exchange_n(ptr, &expected, desired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/* Full barrier, for the store-then-load handshakes acquire/release can't order */
+#define Atomic_Fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#if defined(__x86_64__) || defined(__i386__)
+#define Atomic_Pause() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define Atomic_Pause() __asm__ volatile("yield")
+#else
+#define Atomic_Pause() ((void)0)
+#endif
+
+#endif
+
+/* Padding unit for data several threads hammer, 64 bytes on every x86-64 and most ARM parts */
+#define ATOMIC_CACHE_LINE_SIZE 64
+
+/* A counter alone on its cache line, so writers of neighbouring data don't false-share it */
+typedef struct atomicpaddedu32_t {
+	volatile U32 value;
+	U8 padding[ATOMIC_CACHE_LINE_SIZE - sizeof(U32)];
+} AtomicPaddedU32;
+
+/* Raises *ptr to value if it is larger, for high-water marks */
+static inline void Atomic_MaxU64(volatile U64* ptr, U64 value) {
+	U64 current = Atomic_LoadU64(ptr);
+	while (current < value && !Atomic_CompareExchangeU64(ptr, current, value)) {
+		current = Atomic_LoadU64(ptr);
+	}
+}
@@ -0,0 +1,459 @@
+/*
+	Scanner and pipeline benchmark.
+
+	Built from Bench/Bench.c and Bench/Corpus.c plus every compiler source except
+	Main.c. Build with MEMORY_STATS defined to get allocation counts, they are
+	reported as null otherwise.
+
+	della-bench [--size MiB] [--identifiers W] [--numbers W] [--operators W] [--keywords W]
+	            [--whitespace PCT] [--seed N] [--iterations N] [--threads N]
+	            [--out report.json] [--write-corpus path]
+
+	Prints (or writes) a JSON report meant to be diffed between releases.
+*/
+#include "Corpus.h"
+#include "../Scanner.h"
+#include "../ScannerKernels.h"
+#include "../Keyword.h"
+#include "../StringKernels.h"
+#include "../Compiler.h"
+#include "../CPU.h"
+#include "../FS.h"
+#include "../Memory.h"
+#include "../Timer.h"
+#include "../Output.h"
+#include "../String.h"
+#include "../Logger.h"
+
+#define BENCH_CORPUS_PATH "della-bench-corpus.della"
+
+#define BENCH_RELEX_EDITS 96        // edit and undo pairs per iteration, cycling replace, insert, delete
+#define BENCH_RELEX_REACH 512       // how far the cursor wanders between local edits
+#define BENCH_RELEX_SLACK 16        // room in the relex copy for inserted text
+
+typedef struct benchoptions_t {
+	CorpusOptions corpus;
+	U32 iterations;
+	U32 threads;
+	const char* out_path;
+	const char* corpus_path;
+} BenchOptions;
+
+typedef struct benchresult_t {
+	const char* name;
+	U32 iterations;
+	U64 best_ns;
+	U64 total_ns;
+	U64 tokens;                 // per iteration, over the timed ones
+	U64 edits;                  // per iteration, set for latency benches
+	U64 allocations;            // over all iterations, Malloc + Realloc
+	Bool has_allocations;
+} BenchResult;
+
+typedef struct benchcontext_t {
+	U8* data;
+	Size_t size;
+	ThreadPool* pool;
+	const BenchOptions* options;
+	const CPUInfo* cpu_info;
+
+	/* benches that time only part of an iteration add to these, RunBench resets them */
+	U64 measured_ns;
+	U64 edits;
+
+	/* relex edits its own copy of the corpus and keeps this stream of it up to date */
+	U8* relex_data;
+	U32 relex_size;
+	U32 relex_cursor;
+	U32 relex_seed;
+	TokenBuffer* relex_tokens;
+	Interner* relex_interner;
+	Arena* relex_arena;
+} BenchContext;
+
+typedef U64 (*BenchFn)(BenchContext* context);
+
+/* Each iteration starts from nothing so the allocation count includes setup */
+static U64 BenchScanSerial(BenchContext* context) {
+	Arena* arena = Arena_Create(ARENA_DEFAULT_BLOCK_SIZE);
+	Interner* interner = Interner_Create(arena, 256);
+	TokenBuffer* tokens = TokenBuffer_Create(TokenBuffer_EstimateCapacity(context->size), context->data);
+
+	ScannerTokenize(StrView_Make(context->data, (U32)context->size), tokens, interner);
+	U64 count = tokens->count;
+
+	TokenBuffer_Free(tokens);
+	Interner_Destroy(interner);
+	Arena_Destroy(arena);
+	return count;
+}
+
+/* Same as scan, tokens come from the generated DFA tables instead of the switch */
+static U64 BenchScanTable(BenchContext* context) {
+	Scanner_SetMode(SCANNER_MODE_TABLE);
+	U64 count = BenchScanSerial(context);
+	Scanner_SetMode(SCANNER_MODE_SWITCH);
+	return count;
+}
+
+static U64 BenchScanParallel(BenchContext* context) {
+	Arena* arena = Arena_Create(ARENA_DEFAULT_BLOCK_SIZE);
+	Interner* interner = Interner_Create(arena, 256);
+	TokenBuffer* tokens = TokenBuffer_Create(TokenBuffer_EstimateCapacity(context->size), context->data);
+
+	U32 chunk_count = ThreadPool_GetWorkerSlots(context->pool) * 2;
+	ScannerTokenizeParallel(StrView_Make(context->data, (U32)context->size), tokens, interner, context->pool, chunk_count);
+	U64 count = tokens->count;
+
+	TokenBuffer_Free(tokens);
+	Interner_Destroy(interner);
+	Arena_Destroy(arena);
+	return count;
+}
+
+/* Pulls tokens one at a time the way a parser would, nothing is materialized */
+static U64 BenchScanIterate(BenchContext* context) {
+	Arena* arena = Arena_Create(ARENA_DEFAULT_BLOCK_SIZE);
+	Interner* interner = Interner_Create(arena, 256);
+
+	ScannerInfo sInfo = ScannerInit(StrView_Make(context->data, (U32)context->size), NULL, interner);
+	U64 count = 0;
+	for (;;) {
+		Token token = Scanner_Next(&sInfo);
+		count++;
+		if (token.kind == TOKEN_EOF) break;
+	}
+
+	Interner_Destroy(interner);
+	Arena_Destroy(arena);
+	return count;
+}
+
+/* Same drain, with the scanning on its own thread behind the batch ring */
+static U64 BenchScanPipeline(BenchContext* context) {
+	Arena* arena = Arena_Create(ARENA_DEFAULT_BLOCK_SIZE);
+	Interner* interner = Interner_Create(arena, 256);
+
+	ScannerPipe* pipe = ScannerPipe_Start(StrView_Make(context->data, (U32)context->size), interner);
+	if (pipe == NULL) {
+		/* no thread to scan on, drain on this one */
+		Interner_Destroy(interner);
+		Arena_Destroy(arena);
+		return BenchScanIterate(context);
+	}
+
+	U64 count = 0;
+	for (;;) {
+		Token token = ScannerPipe_Next(pipe);
+		count++;
+		if (token.kind == TOKEN_EOF) break;
+	}
+	ScannerPipe_Finish(pipe);
+
+	Interner_Destroy(interner);
+	Arena_Destroy(arena);
+	return count;
+}
+
+static U32 BenchRelexRandom(BenchContext* context) {
+	context->relex_seed = context->relex_seed * 1664525 + 1013904223;
+	return context->relex_seed;
+}
+
+/* Edits the text the way an editor would, this part isn't timed */
+static void BenchRelexEditText(BenchContext* context, U32 offset, U32 removed, const U8* text, U32 inserted) {
+	U8* at = context->relex_data + offset;
+	Memmove(at + inserted, at + removed, (Size_t)(context->relex_size - offset - removed) + 1);
+	Memcpy(at, text, inserted);
+	context->relex_size = context->relex_size - removed + inserted;
+}
+
+/* Times one relex, returns the tokens it rescanned */
+static U64 BenchRelexApply(BenchContext* context, U32 offset, U32 removed, U32 inserted) {
+	StrView source = StrView_Make(context->relex_data, context->relex_size);
+	ScannerEdit edit = {.offset= offset, .removed= removed, .inserted= inserted};
+
+	U64 start = Timer_Now();
+	ScannerRelexResult result = ScannerRelex(context->relex_tokens, context->relex_interner, source, edit);
+	context->measured_ns += Timer_Now() - start;
+	context->edits++;
+	return result.inserted;
+}
+
+/*
+	Edits and undoes them, each followed by a relex: a byte replaced by '+',
+	"x1 " inserted and two bytes deleted, in turn. Only the relex calls are
+	timed. Local edits follow a cursor that wanders a little like typing does,
+	far ones land anywhere and also pay for moving the gap across the file.
+	Inserting and deleting move the text behind the edit, which isn't timed
+	but leaves those relexes to start with cold caches.
+*/
+static U64 BenchRelexEdits(BenchContext* context, Bool far) {
+	static const U8 insert_text[] = "x1 ";
+	U64 rescanned = 0;
+
+	for (U32 i = 0; i < BENCH_RELEX_EDITS; i++) {
+		U32 span = context->relex_size - 2;
+		U32 random = BenchRelexRandom(context);
+		if (far) {
+			context->relex_cursor = (U32)(((U64)random * span) >> 32);
+		}
+		else {
+			context->relex_cursor = (context->relex_cursor + span + random % (2 * BENCH_RELEX_REACH + 1) - BENCH_RELEX_REACH) % span;
+		}
+		U32 offset = context->relex_cursor;
+
+		switch (i % 3) {
+			case 0: {
+				U8 original = context->relex_data[offset];
+				context->relex_data[offset] = '+';
+				rescanned += BenchRelexApply(context, offset, 1, 1);
+				context->relex_data[offset] = original;
+				rescanned += BenchRelexApply(context, offset, 1, 1);
+				break;
+			}
+			case 1: {
+				BenchRelexEditText(context, offset, 0, insert_text, sizeof(insert_text) - 1);
+				rescanned += BenchRelexApply(context, offset, 0, sizeof(insert_text) - 1);
+				BenchRelexEditText(context, offset, sizeof(insert_text) - 1, NULL, 0);
+				rescanned += BenchRelexApply(context, offset, sizeof(insert_text) - 1, 0);
+				break;
+			}
+			default: {
+				U8 removed[2] = {context->relex_data[offset], context->relex_data[offset + 1]};
+				BenchRelexEditText(context, offset, 2, NULL, 0);
+				rescanned += BenchRelexApply(context, offset, 2, 0);
+				BenchRelexEditText(context, offset, 0, removed, 2);
+				rescanned += BenchRelexApply(context, offset, 0, 2);
+				break;
+			}
+		}
+	}
+	return rescanned;
+}
+
+static U64 BenchRelexLocal(BenchContext* context) {
+	return BenchRelexEdits(context, FALSE);
+}
+
+static U64 BenchRelexFar(BenchContext* context) {
+	return BenchRelexEdits(context, TRUE);
+}
+
+/* Whole driver on the corpus file: mapping, every phase that exists, teardown */
+static U64 BenchPipeline(BenchContext* context) {
+	const char* path = context->options->corpus_path;
+
+	CompilerOptions options = {0};
+	options.input_paths = &path;
+	options.input_count = 1;
+	options.thread_count = context->options->threads;
+	CompilerMain(&options, context->cpu_info);
+	return 0;
+}
+
+static BenchResult RunBench(const char* name, BenchFn fn, BenchContext* context, U64 tokens) {
+	BenchResult result = {0};
+	result.name = name;
+	result.iterations = context->options->iterations;
+	result.best_ns = (U64)-1;
+
+	/* one untimed run to fault in the corpus and warm the allocator */
+	fn(context);
+
+	MemoryStats before, after;
+	result.has_allocations = Memory_GetStats(&before);
+
+	U64 counted = 0;
+	for (U32 i = 0; i < result.iterations; i++) {
+		context->measured_ns = 0;
+		context->edits = 0;
+		U64 start = Timer_Now();
+		counted += fn(context);
+		U64 elapsed = Timer_Now() - start;
+		if (context->measured_ns != 0) elapsed = context->measured_ns;
+
+		result.total_ns += elapsed;
+		result.edits += context->edits;
+		if (elapsed < result.best_ns) result.best_ns = elapsed;
+	}
+
+	Memory_GetStats(&after);
+	result.allocations = (after.allocations - before.allocations) + (after.reallocations - before.reallocations);
+	result.tokens = counted ? counted / result.iterations : tokens;
+	result.edits /= result.iterations;
+	return result;
+}
+
+static void ReportResult(Output* json, const BenchResult* result, Size_t bytes, Bool last) {
+	double best_seconds = (double)result->best_ns / 1e9;
+	double mean_seconds = (double)result->total_ns / 1e9 / result->iterations;
+
+	Output_Format(json, "    {\n");
+	Output_Format(json, "      \"name\": \"%s\",\n", result->name);
+	Output_Format(json, "      \"iterations\": %u,\n", result->iterations);
+	Output_Format(json, "      \"best_seconds\": %.6f,\n", best_seconds);
+	Output_Format(json, "      \"mean_seconds\": %.6f,\n", mean_seconds);
+	if (result->edits != 0) {
+		/* latency benches, throughput over the file means nothing for them */
+		double edits = (double)result->edits;
+		Output_Format(json, "      \"edits\": %llu,\n", (unsigned long long)result->edits);
+		Output_Format(json, "      \"best_ns_per_edit\": %.1f,\n", (double)result->best_ns / edits);
+		Output_Format(json, "      \"mean_ns_per_edit\": %.1f,\n", (double)result->total_ns / result->iterations / edits);
+		Output_Format(json, "      \"rescanned_per_edit\": %.2f,\n", (double)result->tokens / edits);
+		if (result->has_allocations) {
+			Output_Format(json, "      \"allocations_per_edit\": %.6f\n", (double)result->allocations / (edits * result->iterations));
+		}
+		else {
+			Output_Format(json, "      \"allocations_per_edit\": null\n");
+		}
+		Output_Format(json, "    }%s\n", last ? "" : ",");
+		return;
+	}
+	Output_Format(json, "      \"mb_per_s\": %.2f,\n", (double)bytes / (1024.0 * 1024.0) / best_seconds);
+	Output_Format(json, "      \"tokens_per_s\": %.0f,\n", (double)result->tokens / best_seconds);
+	Output_Format(json, "      \"ns_per_token\": %.3f,\n", (double)result->best_ns / (double)result->tokens);
+	if (result->has_allocations) {
+		Output_Format(json, "      \"allocations_per_token\": %.6f\n",
+			(double)result->allocations / ((double)result->tokens * result->iterations));
+	}
+	else {
+		Output_Format(json, "      \"allocations_per_token\": null\n");
+	}
+	Output_Format(json, "    }%s\n", last ? "" : ",");
+}
+
+static U32 ParseNumber(const char* text) {
+	U32 value = 0;
+	for (; *text >= '0' && *text <= '9'; text++) {
+		value = value * 10 + (U32)(*text - '0');
+	}
+	return value;
+}
+
+static Bool ArgIs(const char* arg, const char* option) {
+	return StringCompare((const U8*)arg, (const U8*)option) == 0;
+}
+
+static Bool ParseArguments(int argc, char** argv, BenchOptions* options) {
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		if (i + 1 >= argc) return FALSE;
+		const char* value = argv[++i];
+
+		if (ArgIs(arg, "--size")) options->corpus.size = (Size_t)ParseNumber(value) * 1024 * 1024;
+		else if (ArgIs(arg, "--identifiers")) options->corpus.identifier_weight = ParseNumber(value);
+		else if (ArgIs(arg, "--numbers")) options->corpus.number_weight = ParseNumber(value);
+		else if (ArgIs(arg, "--operators")) options->corpus.operator_weight = ParseNumber(value);
+		else if (ArgIs(arg, "--keywords")) options->corpus.keyword_weight = ParseNumber(value);
+		else if (ArgIs(arg, "--whitespace")) options->corpus.whitespace_percent = ParseNumber(value);
+		else if (ArgIs(arg, "--seed")) options->corpus.seed = ParseNumber(value);
+		else if (ArgIs(arg, "--iterations")) options->iterations = ParseNumber(value);
+		else if (ArgIs(arg, "--threads")) options->threads = ParseNumber(value);
+		else if (ArgIs(arg, "--out")) options->out_path = value;
+		else if (ArgIs(arg, "--write-corpus")) options->corpus_path = value;
+		else return FALSE;
+	}
+	return options->iterations != 0 && options->corpus.size != 0;
+}
+
+int main(int argc, char** argv) {
+	BenchOptions options = {0};
+	options.corpus = Corpus_DefaultOptions();
+	options.iterations = 10;
+	options.corpus_path = BENCH_CORPUS_PATH;
+
+	if (!ParseArguments(argc, argv, &options)) {
+		Print("usage: della-bench [--size MiB] [--identifiers W] [--numbers W] [--operators W] [--keywords W]\n"
+			"                   [--whitespace PCT] [--seed N] [--iterations N] [--threads N]\n"
+			"                   [--out report.json] [--write-corpus path]\n");
+		return 1;
+	}
+
+	CPUInfo cpu_info = {0};
+	DetectArch(&cpu_info);
+	ScannerKernelsInit(&cpu_info);
+	KeywordCheckList();
+	StringKernelsInit(&cpu_info);
+	if (options.threads == 0) options.threads = cpu_info.number_of_processors ? cpu_info.number_of_processors : 1;
+
+	BenchContext context = {0};
+	context.options = &options;
+	context.cpu_info = &cpu_info;
+	context.data = Corpus_Generate(&options.corpus, &context.size);
+	context.pool = ThreadPool_Create(options.threads - 1);
+
+	if (!FS_WriteFile(options.corpus_path, (const char*)context.data, context.size)) {
+		LOG_ERROR("Couldn't write the corpus file\n");
+		return 1;
+	}
+
+	context.relex_data = Malloc(context.size + BENCH_RELEX_SLACK);
+	if (context.relex_data == NULL) {
+		PANIC("Malloc Failed");
+	}
+	Memcpy(context.relex_data, context.data, context.size);
+	context.relex_data[context.size] = '\0';
+	context.relex_size = (U32)context.size;
+	context.relex_cursor = context.relex_size / 2;
+	context.relex_arena = Arena_Create(ARENA_DEFAULT_BLOCK_SIZE);
+	context.relex_interner = Interner_Create(context.relex_arena, 256);
+	context.relex_tokens = TokenBuffer_Create(TokenBuffer_EstimateCapacity(context.size), context.relex_data);
+	ScannerTokenize(StrView_Make(context.relex_data, context.relex_size), context.relex_tokens, context.relex_interner);
+
+	BenchResult results[8];
+	U32 result_count = 0;
+	results[result_count++] = RunBench("scan", BenchScanSerial, &context, 0);
+	results[result_count++] = RunBench("scan_table", BenchScanTable, &context, 0);
+	results[result_count++] = RunBench("scan_iterate", BenchScanIterate, &context, 0);
+	results[result_count++] = RunBench("scan_pipeline", BenchScanPipeline, &context, 0);
+	if (options.threads > 1) {
+		results[result_count++] = RunBench("scan_parallel", BenchScanParallel, &context, 0);
+	}
+	results[result_count++] = RunBench("relex", BenchRelexLocal, &context, 0);
+	results[result_count++] = RunBench("relex_far", BenchRelexFar, &context, 0);
+	results[result_count++] = RunBench("pipeline", BenchPipeline, &context, results[0].tokens);
+
+	Output json;
+	if (options.out_path == NULL) {
+		Output_InitStandard(&json, OUTPUT_STDOUT);
+	}
+	else if (!Output_OpenFile(&json, options.out_path)) {
+		LOG_ERROR("Couldn't open %s\n", options.out_path);
+		return 1;
+	}
+	Output_Format(&json, "{\n");
+	Output_Format(&json, "  \"corpus\": {\n");
+	Output_Format(&json, "    \"bytes\": %llu,\n", (unsigned long long)context.size);
+	Output_Format(&json, "    \"tokens\": %llu,\n", (unsigned long long)results[0].tokens);
+	Output_Format(&json, "    \"seed\": %u,\n", options.corpus.seed);
+	Output_Format(&json, "    \"identifier_weight\": %u,\n", options.corpus.identifier_weight);
+	Output_Format(&json, "    \"number_weight\": %u,\n", options.corpus.number_weight);
+	Output_Format(&json, "    \"operator_weight\": %u,\n", options.corpus.operator_weight);
+	Output_Format(&json, "    \"keyword_weight\": %u,\n", options.corpus.keyword_weight);
+	Output_Format(&json, "    \"whitespace_percent\": %u\n", options.corpus.whitespace_percent);
+	Output_Format(&json, "  },\n");
+	Output_Format(&json, "  \"machine\": {\n");
+	Output_Format(&json, "    \"vendor\": \"%s\",\n", cpu_info.vendor_id ? (const char*)cpu_info.vendor_id : "");
+	Output_Format(&json, "    \"processors\": %u,\n", cpu_info.number_of_processors);
+	Output_Format(&json, "    \"threads\": %u,\n", options.threads);
+	Output_Format(&json, "    \"scanner_kernels\": \"%s\"\n", g_scannerKernels.name);
+	Output_Format(&json, "  },\n");
+	Output_Format(&json, "  \"results\": [\n");
+	for (U32 i = 0; i < result_count; i++) {
+		ReportResult(&json, &results[i], context.size, i + 1 == result_count);
+	}
+	Output_Format(&json, "  ],\n");
+	Output_Format(&json, "  \"peak_rss_bytes\": %llu\n", (unsigned long long)Memory_GetPeakRSS());
+	Output_Format(&json, "}\n");
+
+	Output_Close(&json);
+	TokenBuffer_Free(context.relex_tokens);
+	Interner_Destroy(context.relex_interner);
+	Arena_Destroy(context.relex_arena);
+	Free(context.relex_data);
+	ThreadPool_Destroy(context.pool);
+	Free(context.data);
+	DeallocateCPUInfo(&cpu_info);
+	return 0;
+}
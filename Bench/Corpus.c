@@ -0,0 +1,125 @@
+#include "Corpus.h"
+#include "../Memory.h"
+#include "../Logger.h"
+
+#define CORPUS_VOCABULARY_SIZE 4096
+#define CORPUS_MAX_TOKEN 64
+
+static const char* CorpusKeywords[] = { "func", "if", "else", "for", "while" };
+static const char CorpusOperators[] = "(){}*/+-;:,<>=@";
+
+typedef struct corpusrng_t {
+	U64 state;
+} CorpusRng;
+
+/* xorshift64*, deterministic for a given seed on every platform */
+static U32 RngNext(CorpusRng* rng) {
+	rng->state ^= rng->state >> 12;
+	rng->state ^= rng->state << 25;
+	rng->state ^= rng->state >> 27;
+	return (U32)((rng->state * 2685821657736338717ull) >> 32);
+}
+
+static U32 RngRange(CorpusRng* rng, U32 count) {
+	return RngNext(rng) % count;
+}
+
+CorpusOptions Corpus_DefaultOptions(void) {
+	return (CorpusOptions) {
+		.size = 16 * 1024 * 1024,
+		.identifier_weight = 40,
+		.number_weight = 15,
+		.operator_weight = 35,
+		.keyword_weight = 10,
+		.whitespace_percent = 15,
+		.seed = 1,
+	};
+}
+
+/*
+	Identifiers come from a fixed vocabulary with a skewed pick, so a few names
+	are very common and most are rare, roughly like real code.
+*/
+static U32 GenerateIdentifier(CorpusRng* rng, U8 (*vocabulary)[CORPUS_MAX_TOKEN], U8* lengths, U8* out) {
+	U32 pick = RngRange(rng, CORPUS_VOCABULARY_SIZE);
+	U32 index = (U32)(((U64)pick * pick) / CORPUS_VOCABULARY_SIZE);
+	Memcpy(out, vocabulary[index], lengths[index]);
+	return lengths[index];
+}
+
+static U32 GenerateNumber(CorpusRng* rng, U8* out) {
+	U32 length = 1 + RngRange(rng, 10);
+	for (U32 i = 0; i < length; i++) {
+		out[i] = (U8)('0' + RngRange(rng, 10));
+	}
+	return length;
+}
+
+U8* Corpus_Generate(const CorpusOptions* options, Size_t* size) {
+	CorpusRng rng = { .state = 0x9E3779B97F4A7C15ull ^ options->seed };
+
+	U8 (*vocabulary)[CORPUS_MAX_TOKEN] = Malloc(CORPUS_VOCABULARY_SIZE * CORPUS_MAX_TOKEN);
+	U8* lengths = Malloc(CORPUS_VOCABULARY_SIZE);
+	for (U32 i = 0; i < CORPUS_VOCABULARY_SIZE; i++) {
+		lengths[i] = (U8)(1 + RngRange(&rng, 16));
+		for (U32 c = 0; c < lengths[i]; c++) {
+			U32 letter = RngRange(&rng, 52);
+			vocabulary[i][c] = (U8)(letter < 26 ? 'a' + letter : 'A' + letter - 26);
+		}
+	}
+
+	U32 total_weight = options->identifier_weight + options->number_weight +
+		options->operator_weight + options->keyword_weight;
+	if (total_weight == 0) {
+		PANIC("Corpus needs at least one non-zero token weight");
+	}
+
+	/* room for one more token and its trailing whitespace past the target */
+	Size_t capacity = options->size + 2 * CORPUS_MAX_TOKEN + 1;
+	U8* data = Malloc(capacity);
+	if (data == NULL) {
+		PANIC("Couldn't allocate corpus");
+	}
+
+	Size_t length = 0;
+	while (length < options->size) {
+		U32 pick = RngRange(&rng, total_weight);
+		U8* out = data + length;
+
+		if (pick < options->identifier_weight) {
+			length += GenerateIdentifier(&rng, vocabulary, lengths, out);
+		}
+		else if ((pick -= options->identifier_weight) < options->number_weight) {
+			length += GenerateNumber(&rng, out);
+		}
+		else if ((pick -= options->number_weight) < options->operator_weight) {
+			*out = (U8)CorpusOperators[RngRange(&rng, sizeof(CorpusOperators) - 1)];
+			length += 1;
+		}
+		else {
+			const char* keyword = CorpusKeywords[RngRange(&rng, sizeof(CorpusKeywords) / sizeof(*CorpusKeywords))];
+			U32 keyword_length = 0;
+			while (keyword[keyword_length]) {
+				out[keyword_length] = (U8)keyword[keyword_length];
+				keyword_length++;
+			}
+			length += keyword_length;
+		}
+
+		if (RngRange(&rng, 100) < options->whitespace_percent) {
+			data[length++] = '\n';
+			U32 indent = RngRange(&rng, 33);
+			for (U32 i = 0; i < indent; i++) data[length++] = ' ';
+		}
+		else {
+			data[length++] = ' ';
+		}
+	}
+
+	data[length] = '\0';
+	*size = length;
+
+	Free(vocabulary);
+	Free(lengths);
+	return data;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "../Common.h"
+
+/*
+	Synthetic .della source generator for benchmarks.
+	The weights pick the kind of every generated token relative to each other,
+	whitespace_percent is the chance that a token is followed by a line break
+	and an indentation run instead of a single space.
+*/
+typedef struct corpusoptions_t {
+	Size_t size;                // approximate output size in bytes
+	U32 identifier_weight;
+	U32 number_weight;
+	U32 operator_weight;
+	U32 keyword_weight;
+	U32 whitespace_percent;
+	U32 seed;
+} CorpusOptions;
+
+CorpusOptions Corpus_DefaultOptions(void);
+
+/* Returns a NUL-terminated buffer of about options->size bytes, free it with Free */
+U8* Corpus_Generate(const CorpusOptions* options, Size_t* size);
@@ -0,0 +1,150 @@
+/*
+	Micro-benchmarks for the String.h / Memcpy primitives against libc.
+
+	Built from Bench/StringBench.c plus every compiler source except Main.c.
+
+	della-string-bench [--iterations N]
+
+	Every routine runs over the same buffers at a range of sizes, the table
+	shows ns per call for the selected kernels and for the libc equivalent.
+*/
+#include "../String.h"
+#include "../StringKernels.h"
+#include "../Memory.h"
+#include "../Timer.h"
+#include "../Output.h"
+#include "../CPU.h"
+
+#include <string.h>
+
+#define STRING_BENCH_MAX_SIZE 8192
+
+static const U32 g_benchSizes[] = {7, 16, 33, 64, 200, 1024, 8192};
+
+static volatile U64 g_benchSink;
+
+typedef struct stringbenchbuffers_t {
+	U8* first;
+	U8* second;
+	U8* dest;
+} StringBenchBuffers;
+
+typedef U64 (*StringBenchFn)(StringBenchBuffers* buffers, U32 size);
+
+/* first and second hold the same size-byte string, the interesting work is in the equal prefix */
+static void FillBuffers(StringBenchBuffers* buffers, U32 size) {
+	for (U32 i = 0; i < size; i++) {
+		U8 c = (U8)('a' + (i * 7) % 26);
+		buffers->first[i] = c;
+		buffers->second[i] = c;
+	}
+	buffers->first[size] = '\0';
+	buffers->second[size] = '\0';
+}
+
+static U64 LengthDella(StringBenchBuffers* b, U32 size) { (void)size; return GetStringLength((const char*)b->first); }
+static U64 LengthLibc(StringBenchBuffers* b, U32 size) { (void)size; return strlen((const char*)b->first); }
+
+static U64 CompareDella(StringBenchBuffers* b, U32 size) { (void)size; return (U64)StringCompare(b->first, b->second); }
+static U64 CompareLibc(StringBenchBuffers* b, U32 size) { (void)size; return (U64)strcmp((const char*)b->first, (const char*)b->second); }
+
+static U64 EqualDella(StringBenchBuffers* b, U32 size) { return StringEqualLength(b->first, size, b->second, size); }
+static U64 EqualLibc(StringBenchBuffers* b, U32 size) { return memcmp(b->first, b->second, size) == 0; }
+
+/* the byte is absent, so the whole buffer is searched */
+static U64 FindDella(StringBenchBuffers* b, U32 size) { return StringFindByte(b->first, '#', size) != NULL; }
+static U64 FindLibc(StringBenchBuffers* b, U32 size) { return memchr(b->first, '#', size) != NULL; }
+
+/* libc has nothing that counts, the baseline is the plain loop it would be written as */
+static U64 CountDella(StringBenchBuffers* b, U32 size) { return StringCountByte(b->first, 'a', size); }
+static U64 CountLibc(StringBenchBuffers* b, U32 size) {
+	U64 count = 0;
+	for (U32 i = 0; i < size; i++) count += b->first[i] == 'a';
+	return count;
+}
+
+static U64 CopyDella(StringBenchBuffers* b, U32 size) { Memcpy(b->dest, b->first, size); return b->dest[0]; }
+static U64 CopyLibc(StringBenchBuffers* b, U32 size) { memcpy(b->dest, b->first, size); return b->dest[0]; }
+
+typedef struct stringbenchcase_t {
+	const char* name;
+	StringBenchFn della;
+	StringBenchFn libc;
+} StringBenchCase;
+
+static const StringBenchCase g_benchCases[] = {
+	{"length", LengthDella, LengthLibc},
+	{"compare", CompareDella, CompareLibc},
+	{"equal", EqualDella, EqualLibc},
+	{"find_byte", FindDella, FindLibc},
+	{"count_byte", CountDella, CountLibc},
+	{"copy", CopyDella, CopyLibc},
+};
+
+static double TimeCall(StringBenchFn fn, StringBenchBuffers* buffers, U32 size, U32 iterations) {
+	/* best of a few rounds, the first one also warms the caches */
+	U64 best = (U64)-1;
+	for (U32 round = 0; round < 5; round++) {
+		U64 start = Timer_Now();
+		U64 sink = 0;
+		for (U32 i = 0; i < iterations; i++) {
+			sink += fn(buffers, size);
+		}
+		U64 elapsed = Timer_Now() - start;
+		g_benchSink += sink;
+		if (elapsed < best) best = elapsed;
+	}
+	return (double)best / (double)iterations;
+}
+
+static U32 ParseNumber(const char* text) {
+	U32 value = 0;
+	for (; *text >= '0' && *text <= '9'; text++) {
+		value = value * 10 + (U32)(*text - '0');
+	}
+	return value;
+}
+
+int main(int argc, char** argv) {
+	U32 iterations = 200000;
+	if (argc == 3 && StringCompare((const U8*)argv[1], (const U8*)"--iterations") == 0) {
+		iterations = ParseNumber(argv[2]);
+	}
+	if (iterations == 0) iterations = 1;
+
+	CPUInfo cpu_info = {0};
+	DetectArch(&cpu_info);
+	StringKernelsInit(&cpu_info);
+
+	StringBenchBuffers buffers;
+	buffers.first = Malloc(STRING_BENCH_MAX_SIZE + 64);
+	buffers.second = Malloc(STRING_BENCH_MAX_SIZE + 64);
+	buffers.dest = Malloc(STRING_BENCH_MAX_SIZE + 64);
+
+	Output out;
+	Output_InitStandard(&out, OUTPUT_STDOUT);
+	Output_Format(&out, "kernels: %s\n\n", g_stringKernels.name);
+	Output_Format(&out, "%-10s %6s %12s %12s %8s\n", "routine", "size", "della ns", "libc ns", "ratio");
+
+	for (U32 c = 0; c < sizeof(g_benchCases) / sizeof(*g_benchCases); c++) {
+		const StringBenchCase* bench = &g_benchCases[c];
+		for (U32 s = 0; s < sizeof(g_benchSizes) / sizeof(*g_benchSizes); s++) {
+			U32 size = g_benchSizes[s];
+			FillBuffers(&buffers, size);
+
+			/* fewer calls for the big sizes keeps every row around the same wall time */
+			U32 scaled = iterations / (1 + size / 256);
+			if (scaled == 0) scaled = 1;
+			double della = TimeCall(bench->della, &buffers, size, scaled);
+			double libc = TimeCall(bench->libc, &buffers, size, scaled);
+			Output_Format(&out, "%-10s %6u %12.2f %12.2f %8.2f\n", bench->name, size, della, libc, libc / della);
+		}
+	}
+
+	Output_Close(&out);
+	Free(buffers.first);
+	Free(buffers.second);
+	Free(buffers.dest);
+	DeallocateCPUInfo(&cpu_info);
+	return 0;
+}
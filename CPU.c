@@ -1,9 +1,13 @@
 #include "CPU.h"
 #include "CPU_Win32.h"
+#include "CPU_Linux.h"
+#include "Memory.h"
 
 void DetectArch(CPUInfo* info) {
 #ifdef _WIN32
 	Win32_DetectArch(info);
+#elif defined(__linux__)
+	Linux_DetectArch(info);
 #endif
 }
 
@@ -13,11 +17,29 @@ void DebugCPUInfo(CPUInfo info) {
         "Architecture: %s\n"
         "Word Size: %d\n"
         "Number of processors: %d\n"
+        "Number of cores: %d\n"
+        "Number of NUMA nodes: %d\n"
         "Has SSE: %s\n"
-        "Has AVX: %s\n",
+        "Has SSE4.2: %s\n"
+        "Has AVX: %s\n"
+        "Has AVX2: %s\n"
+        "Has AVX-512: %s\n"
+        "Has BMI2: %s\n"
+        "Has POPCNT: %s\n"
+        "L1 data cache: %u bytes\n"
+        "L2 cache: %u bytes\n"
+        "L3 cache: %u bytes\n"
+        "Cache line: %u bytes\n",
         info.vendor_id, GetProcessorArchString(info.arch), info.word_size,
-        info.number_of_processors, info.has_sse ? "true" : "false",
-        info.has_avx ? "true" : "false"
+        info.number_of_processors, info.number_of_cores, info.number_of_numa_nodes,
+        info.has_sse ? "true" : "false",
+        info.has_sse42 ? "true" : "false",
+        info.has_avx ? "true" : "false",
+        info.has_avx2 ? "true" : "false",
+        info.has_avx512 ? "true" : "false",
+        info.has_bmi2 ? "true" : "false",
+        info.has_popcnt ? "true" : "false",
+        info.l1_data_cache_size, info.l2_cache_size, info.l3_cache_size, info.cache_line_size
     );
 }
 
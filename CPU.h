@@ -21,10 +21,22 @@ typedef struct cpu_t {
     PROCESSOR_ARCH arch;
     U8 word_size;                // in bytes (4 for 32-bit, 8 for 64-bit)
     U32 number_of_processors;               // default memory alignment
+    U32 number_of_cores;         // physical cores, number_of_processors counts SMT siblings too
+    U32 number_of_numa_nodes;
    
     Bool supports_fma;
     Bool has_sse;                // SIMD support
+    Bool has_sse42;
     Bool has_avx;
+    Bool has_avx2;
+    Bool has_avx512;             // AVX-512 Foundation
+    Bool has_bmi2;
+    Bool has_popcnt;
+
+    U32 l1_data_cache_size;      // in bytes, 0 when unknown
+    U32 l2_cache_size;
+    U32 l3_cache_size;
+    U32 cache_line_size;
 } CPUInfo;
 
 
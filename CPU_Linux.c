@@ -0,0 +1,246 @@
+#ifdef __linux__
+#define _GNU_SOURCE     // sched_getaffinity, CPU_COUNT
+#include "CPU_Linux.h"
+#include "Memory.h"
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CPU_LINUX_X86 1
+#endif
+
+#define CPU_MAX_TRACKED_CORES 1024
+
+/* Reads a small sysfs file into buffer as a NUL-terminated string */
+static Bool ReadSysFile(const char* path, char* buffer, U32 size) {
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return FALSE;
+
+	ssize_t length = read(fd, buffer, size - 1);
+	close(fd);
+	if (length <= 0) return FALSE;
+
+	buffer[length] = '\0';
+	return TRUE;
+}
+
+static U32 ParseNumber(const char** text) {
+	U32 value = 0;
+	while (**text >= '0' && **text <= '9') {
+		value = value * 10 + (U32)(**text - '0');
+		(*text)++;
+	}
+	return value;
+}
+
+/* sysfs sizes look like "48K" or "2048K" */
+static U32 ReadSysSize(const char* path) {
+	char buffer[64];
+	if (!ReadSysFile(path, buffer, sizeof(buffer))) return 0;
+
+	const char* text = buffer;
+	U32 value = ParseNumber(&text);
+	if (*text == 'K') value *= 1024;
+	if (*text == 'M') value *= 1024 * 1024;
+	return value;
+}
+
+static Bool ReadSysNumber(const char* path, U32* value) {
+	char buffer[64];
+	if (!ReadSysFile(path, buffer, sizeof(buffer))) return FALSE;
+
+	const char* text = buffer;
+	*value = ParseNumber(&text);
+	return TRUE;
+}
+
+/* Counts the entries of a sysfs list such as "0-3,8,10-11" */
+static U32 CountSysList(const char* path) {
+	char buffer[256];
+	if (!ReadSysFile(path, buffer, sizeof(buffer))) return 0;
+
+	U32 count = 0;
+	const char* text = buffer;
+	while (*text >= '0' && *text <= '9') {
+		U32 first = ParseNumber(&text);
+		U32 last = first;
+		if (*text == '-') {
+			text++;
+			last = ParseNumber(&text);
+		}
+		count += last - first + 1;
+		if (*text != ',') break;
+		text++;
+	}
+	return count;
+}
+
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+/* sysconf answers -1 (or 0) for what it doesn't know, that stays 0 = unknown */
+static U32 SysconfSize(int name) {
+	long value = sysconf(name);
+	return value > 0 ? (U32)value : 0;
+}
+#endif
+
+static void DetectTopology(CPUInfo* info) {
+	long online = sysconf(_SC_NPROCESSORS_ONLN);
+	U32 online_count = online > 0 ? (U32)online : 1;
+
+	/* count what this process may run on, taskset and cgroup cpusets shrink it below the online count */
+	cpu_set_t affinity;
+	CPU_ZERO(&affinity);
+	Bool has_affinity = sched_getaffinity(0, sizeof(affinity), &affinity) == 0 && CPU_COUNT(&affinity) > 0;
+	info->number_of_processors = has_affinity ? (U32)CPU_COUNT(&affinity) : online_count;
+
+	/* a physical core is a distinct (package, core) pair, SMT siblings share it */
+	static U64 seen[CPU_MAX_TRACKED_CORES];
+	U32 seen_count = 0;
+	char path[128];
+
+	for (U32 cpu = 0; cpu < CPU_MAX_TRACKED_CORES; cpu++) {
+		U32 package_id, core_id;
+
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu);
+		if (!ReadSysNumber(path, &core_id)) {
+			if (cpu >= online_count) break;
+			continue;   // offline cpus have no topology directory
+		}
+		if (has_affinity && cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &affinity)) continue;
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+		if (!ReadSysNumber(path, &package_id)) package_id = 0;
+
+		U64 key = ((U64)package_id << 32) | core_id;
+		Bool known = FALSE;
+		for (U32 i = 0; i < seen_count; i++) {
+			if (seen[i] == key) {
+				known = TRUE;
+				break;
+			}
+		}
+		if (!known) seen[seen_count++] = key;
+	}
+	info->number_of_cores = seen_count ? seen_count : info->number_of_processors;
+
+	info->number_of_numa_nodes = CountSysList("/sys/devices/system/node/online");
+	if (info->number_of_numa_nodes == 0) info->number_of_numa_nodes = 1;
+}
+
+static void DetectCaches(CPUInfo* info) {
+	char path[128];
+	char type[32];
+
+	for (U32 index = 0; index < 16; index++) {
+		U32 level;
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/level", index);
+		if (!ReadSysNumber(path, &level)) break;
+
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/type", index);
+		if (!ReadSysFile(path, type, sizeof(type))) continue;
+		if (type[0] == 'I') continue;   // instruction caches don't matter to us
+
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/size", index);
+		U32 size = ReadSysSize(path);
+
+		if (level == 1) info->l1_data_cache_size = size;
+		if (level == 2) info->l2_cache_size = size;
+		if (level == 3) info->l3_cache_size = size;
+
+		U32 line_size;
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/coherency_line_size", index);
+		if (level == 1 && ReadSysNumber(path, &line_size)) info->cache_line_size = line_size;
+	}
+
+	/* containers sometimes hide the cache directory, glibc still knows */
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+	if (info->l1_data_cache_size == 0) info->l1_data_cache_size = SysconfSize(_SC_LEVEL1_DCACHE_SIZE);
+	if (info->l2_cache_size == 0) info->l2_cache_size = SysconfSize(_SC_LEVEL2_CACHE_SIZE);
+	if (info->l3_cache_size == 0) info->l3_cache_size = SysconfSize(_SC_LEVEL3_CACHE_SIZE);
+	if (info->cache_line_size == 0) info->cache_line_size = SysconfSize(_SC_LEVEL1_DCACHE_LINESIZE);
+#endif
+}
+
+#ifdef CPU_LINUX_X86
+static void CPUID(unsigned func, unsigned regs[4]) {
+	__cpuid_count(func, 0, regs[_REG_EAX], regs[_REG_EBX], regs[_REG_ECX], regs[_REG_EDX]);
+}
+
+static U64 ReadXCR0(void) {
+	unsigned eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((U64)edx << 32) | eax;
+}
+
+static void DetectFeatures(CPUInfo* info) {
+	unsigned regs[4];
+
+	CPUID(0, regs);
+	unsigned max_leaf = regs[_REG_EAX];
+
+	U8* vendor = Malloc(16);
+	if (vendor != NULL) {
+		((unsigned*)vendor)[0] = regs[_REG_EBX];
+		((unsigned*)vendor)[1] = regs[_REG_EDX];
+		((unsigned*)vendor)[2] = regs[_REG_ECX];
+		vendor[12] = 0;
+	}
+	info->vendor_id = vendor;
+
+	CPUID(1, regs);
+	info->has_sse = (regs[_REG_EDX] & (1u << 25)) != 0;
+	info->has_sse42 = (regs[_REG_ECX] & (1u << 20)) != 0;
+	info->has_popcnt = (regs[_REG_ECX] & (1u << 23)) != 0;
+	info->supports_fma = (regs[_REG_ECX] & (1u << 12)) != 0;
+
+	/* AVX state is only usable if the OS saves YMM (and ZMM for AVX-512) registers */
+	Bool os_saves_ymm = FALSE;
+	Bool os_saves_zmm = FALSE;
+	if (regs[_REG_ECX] & (1u << 27)) {
+		U64 xcr0 = ReadXCR0();
+		os_saves_ymm = (xcr0 & 0x6) == 0x6;
+		os_saves_zmm = (xcr0 & 0xE6) == 0xE6;
+	}
+	info->has_avx = os_saves_ymm && (regs[_REG_ECX] & (1u << 28)) != 0;
+	info->supports_fma = info->supports_fma && os_saves_ymm;
+
+	if (max_leaf >= 7) {
+		CPUID(7, regs);
+		info->has_avx2 = os_saves_ymm && (regs[_REG_EBX] & (1u << 5)) != 0;
+		info->has_bmi2 = (regs[_REG_EBX] & (1u << 8)) != 0;
+		info->has_avx512 = os_saves_zmm && (regs[_REG_EBX] & (1u << 16)) != 0;
+	}
+}
+#endif
+
+void Linux_DetectArch(CPUInfo* info) {
+#if defined(__x86_64__)
+	info->arch = ARCH_X86_64;
+#elif defined(__i386__)
+	info->arch = ARCH_INTEL86;
+#elif defined(__aarch64__)
+	info->arch = ARCH_ARM64;
+#elif defined(__arm__)
+	info->arch = ARCH_ARM;
+#else
+	info->arch = ARCH_UNKOWN;
+#endif
+
+	info->word_size = sizeof(void*);
+
+#ifdef CPU_LINUX_X86
+	DetectFeatures(info);
+#endif
+	if (info->vendor_id == NULL) {
+		U8* vendor = Malloc(sizeof("Unknown"));
+		if (vendor != NULL) Memcpy(vendor, "Unknown", sizeof("Unknown"));
+		info->vendor_id = vendor;
+	}
+
+	DetectTopology(info);
+	DetectCaches(info);
+}
+#endif
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "CPU.h"
+
+void Linux_DetectArch(CPUInfo* info);
@@ -33,7 +33,9 @@ void Win32_DetectArch(CPUInfo* info) {
 	info->word_size = sizeof(void*);
 	info->number_of_processors = system_info.dwNumberOfProcessors;
 	info->has_sse = Win32_HasSSE();
+	info->has_sse42 = Win32_HasSSE42();
 	info->has_avx = Win32_HasAVX();
+	info->has_avx2 = Win32_HasAVX2();
 
 	U8* vendor = Malloc(16);
 	if (vendor == NULL) {
@@ -93,5 +95,36 @@ Bool Win32_HasAVX() {
 		return TRUE;
 	}
 
+	return FALSE;
+}
+
+Bool Win32_HasSSE42() {
+	unsigned regs[4];
+
+	CPUID(1, regs);
+
+	// bit 20 of ECX means SSE4.2 support
+	if (regs[_REG_ECX] & (1 << 20)) {
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+Bool Win32_HasAVX2() {
+	unsigned regs[4];
+
+	// the OS has to save the YMM state (OSXSAVE + XCR0 bits 1 and 2) before AVX2 is usable
+	CPUID(1, regs);
+	if (!(regs[_REG_ECX] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6) {
+		return FALSE;
+	}
+
+	// bit 5 of EBX (leaf 7) means AVX2 support
+	CPUID(7, regs);
+	if (regs[_REG_EBX] & (1 << 5)) {
+		return TRUE;
+	}
+
 	return FALSE;
 }
\ No newline at end of file
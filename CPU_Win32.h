@@ -5,4 +5,6 @@
 void Win32_GetVendor(U8* processor_name);
 void Win32_DetectArch(CPUInfo* info);
 Bool Win32_HasSSE();
-Bool Win32_HasAVX();
\ No newline at end of file
+Bool Win32_HasSSE42();
+Bool Win32_HasAVX();
+Bool Win32_HasAVX2();
\ No newline at end of file
@@ -1,23 +1,295 @@
 #include "Compiler.h"
 #include "Scanner.h"
+#include "Parser.h"
 #include "Memory.h"
 #include "FS.h"
+#include "ThreadPool.h"
+#include "Profile.h"
+#include "Logger.h"
 
+typedef struct compilerjob_t {
+	struct compilerdriver_t* driver;
+	StrView file_path;
+	Output output;
+	Bool finished;
+	Bool failed;
+} CompilerJob;
 
+typedef struct compilerdriver_t {
+	const CompilerOptions* options;
+	CompilerJob* jobs;
+	Arena** worker_arenas;      // one per pool worker slot, rewound after every file
+	Arena** symbol_arenas;      // same, for CompilerInfo.symbol_arena
+	ThreadPool* pool;
+	Output sink;                // guarded by output_mutex, except for the job at next_to_print which owns it while it runs
+	Mutex* output_mutex;
+	U32 next_to_print;
+	U32 failed_count;
+} CompilerDriver;
 
-void CompilerMain(const char* file_path) {
-	U8* data = FS_ReadFile(file_path);
-	CompilerInfo compiler_info;
-	ScannerToken t;
-	compiler_info.tokens = Array_Create(10, sizeof(*t));
+void CompilerErrorV(CompilerInfo* info, U32 offset, const char* fmt, va_list args) {
+	if (info->lines.starts == NULL) {
+		LineIndex_Build(&info->lines, info->source, info->arena);
+	}
+	SourcePosition position = LineIndex_Resolve(&info->lines, offset);
 
-	Array_SetPrintFn(compiler_info.tokens, ScannerTokenPrint);
-	Array_SetFreeFn(compiler_info.tokens, ScannerTokenFree);
+	Output_WriteStrView(info->output, info->file_path);
+	Output_WriteChar(info->output, ':');
+	Output_WriteU32(info->output, position.line);
+	Output_WriteChar(info->output, ':');
+	Output_WriteU32(info->output, position.column);
+	Output_WriteString(info->output, ": error: ");
+	Output_FormatV(info->output, fmt, args);
+	Output_WriteChar(info->output, '\n');
+	info->error_count++;
+}
 
-	ScannerTokenize(data, compiler_info.tokens);
-	//CreateParseTree(data);
+void CompilerError(CompilerInfo* info, U32 offset, const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	CompilerErrorV(info, offset, fmt, args);
+	va_end(args);
+}
+
+void CompilerReportIllegalToken(CompilerInfo* info, U32 token) {
+	U32 start = info->tokens->start[token];
+	switch ((ScannerError)info->tokens->value[token]) {
+		case SCANNER_ERROR_CHARACTER:
+			CompilerError(info, start, "illegal character '%c'", info->source.ptr[start]);
+			break;
+		case SCANNER_ERROR_UNTERMINATED_STRING:
+			CompilerError(info, start, "unterminated string literal");
+			break;
+		case SCANNER_ERROR_UNTERMINATED_CHAR:
+			CompilerError(info, start, "unterminated character literal");
+			break;
+		case SCANNER_ERROR_UNTERMINATED_COMMENT:
+			CompilerError(info, start, "unterminated block comment");
+			break;
+		case SCANNER_ERROR_ESCAPE:
+			CompilerError(info, start, "unknown escape sequence in literal");
+			break;
+		case SCANNER_ERROR_CHAR_LENGTH:
+			CompilerError(info, start, "character literal must hold exactly one character");
+			break;
+		case SCANNER_ERROR_NUMBER_OVERFLOW:
+			CompilerError(info, start, "number literal is out of range");
+			break;
+		case SCANNER_ERROR_NUMBER_MALFORMED:
+			CompilerError(info, start, "malformed number literal");
+			break;
+	}
+}
+
+/* The parser pulls tokens while the scanner thread produces them, and collects them on the way */
+static void CompilerParsePipelined(CompilerInfo* info) {
+	ScannerPipe* pipe = ScannerPipe_Start(info->source, info->interner);
+	if (pipe == NULL) {
+		/* no thread to scan on, do it here */
+		ScannerTokenize(info->source, info->tokens, info->interner);
+		CreateParseTree(info, NULL);
+		return;
+	}
+
+	CreateParseTree(info, pipe);
+	ScannerPipe_Finish(pipe);
+}
+
+static void CompilerCompileFile(CompilerInfo* info, const CompilerOptions* options) {
+	const char* path = (const char*)info->file_path.ptr;
+
+	ProfileScope read_scope = Profile_Begin("read", path);
+	Size_t size = 0;
+	U8* data = FS_ReadFile(path, &size);
+	Profile_End(&read_scope);
+	if (data == NULL) {
+		Output_WriteStrView(info->output, info->file_path);
+		Output_WriteString(info->output, ": error: couldn't read file\n");
+		info->error_count++;
+		return;
+	}
+	/* token offsets are 32-bit */
+	if (size >= SCANNER_NO_END) {
+		Output_WriteStrView(info->output, info->file_path);
+		Output_WriteString(info->output, ": error: file is too large\n");
+		info->error_count++;
+		FS_FreeFile(data, size);
+		return;
+	}
+	info->source = StrView_Make(data, (U32)size);
+
+	MALLOC_TAG("scan");
+	info->tokens = TokenBuffer_Create(TokenBuffer_EstimateCapacity(info->source.len), info->source.ptr);
+	info->interner = Interner_Create(info->symbol_arena, 256);
+
+	if (options->pipeline_scan) {
+		ProfileScope parse_scope = Profile_Begin("parse_pipelined", path);
+		CompilerParsePipelined(info);
+		Profile_End(&parse_scope);
+	}
+	else {
+		if (options->parallel_scan || info->source.len >= COMPILER_PARALLEL_SCAN_THRESHOLD) {
+			ProfileScope scan_scope = Profile_Begin("scan_parallel", path);
+			/* a couple of chunks per worker evens out chunks that scan slower */
+			U32 chunk_count = ThreadPool_GetWorkerSlots(info->pool) * 2;
+			ScannerTokenizeParallel(info->source, info->tokens, info->interner, info->pool, chunk_count);
+			Profile_End(&scan_scope);
+		}
+		else {
+			ProfileScope scan_scope = Profile_Begin("scan", path);
+			ScannerTokenize(info->source, info->tokens, info->interner);
+			Profile_End(&scan_scope);
+		}
+
+		MALLOC_TAG("parse");
+		ProfileScope parse_scope = Profile_Begin("parse", path);
+		CreateParseTree(info, NULL);
+		Profile_End(&parse_scope);
+	}
+	if (options->dump_tokens) {
+		MALLOC_TAG("dump_tokens");
+		ProfileScope dump_scope = Profile_Begin("dump_tokens", path);
+		TokenBuffer_Print(info->tokens, info->output);
+		Profile_End(&dump_scope);
+	}
+	if (options->dump_ast) {
+		MALLOC_TAG("dump_ast");
+		ProfileScope dump_scope = Profile_Begin("dump_ast", path);
+		Ast_Print(&info->ast, info->tokens, info->output);
+		Profile_End(&dump_scope);
+	}
 	//CreateAnalysis(data);
 	//GenerateIR(data);
 
-	Print("%s", data);
-}
\ No newline at end of file
+	/* tokens are spans into data, so the file has to be released last */
+	ProfileScope release_scope = Profile_Begin("release", path);
+	TokenBuffer_Free(info->tokens);
+	Interner_Destroy(info->interner);
+	FS_FreeFile(data, size);
+	Profile_End(&release_scope);
+	MALLOC_TAG("driver");
+}
+
+/* Prints every finished file whose predecessors have all been printed, keeping input order */
+static void CompilerFlushFinished(CompilerDriver* driver) {
+	U32 input_count = driver->options->input_count;
+	while (driver->next_to_print < input_count && driver->jobs[driver->next_to_print].finished) {
+		CompilerJob* job = &driver->jobs[driver->next_to_print];
+		Output_WriteOutput(&driver->sink, &job->output);
+		Output_Close(&job->output);
+		driver->next_to_print++;
+	}
+}
+
+static void CompilerFileJob(void* arg, U32 worker_index) {
+	CompilerJob* job = arg;
+	CompilerDriver* driver = job->driver;
+
+	Arena* arena = driver->worker_arenas[worker_index];
+	Arena* symbol_arena = driver->symbol_arenas[worker_index];
+	ArenaMark mark = Arena_Mark(arena);
+	ArenaMark symbol_mark = Arena_Mark(symbol_arena);
+
+	CompilerInfo info = {0};
+	info.file_path = job->file_path;
+	info.arena = arena;
+	info.symbol_arena = symbol_arena;
+	info.pool = driver->pool;
+
+	/* nothing comes before the head of the input order, it writes straight to the sink instead of buffering */
+	Mutex_Lock(driver->output_mutex);
+	Bool streaming = driver->next_to_print == (U32)(job - driver->jobs);
+	Mutex_Unlock(driver->output_mutex);
+	info.output = streaming ? &driver->sink : &job->output;
+
+	ProfileScope file_scope = Profile_Begin("file", (const char*)job->file_path.ptr);
+	CompilerCompileFile(&info, driver->options);
+	Arena_Reset(arena, mark);
+	Arena_Reset(symbol_arena, symbol_mark);
+	Profile_End(&file_scope);
+
+	Mutex_Lock(driver->output_mutex);
+	job->failed = info.error_count != 0;
+	job->finished = TRUE;
+	if (job->failed) driver->failed_count++;
+	CompilerFlushFinished(driver);
+	Mutex_Unlock(driver->output_mutex);
+}
+
+U32 CompilerMain(const CompilerOptions* options, const CPUInfo* cpu_info) {
+	U32 thread_count = options->thread_count;
+	if (thread_count == 0) thread_count = cpu_info->number_of_processors;
+	if (thread_count == 0) thread_count = 1;
+
+	MALLOC_TAG("driver");
+	ProfileScope compile_scope = Profile_Begin("compile", NULL);
+
+	CompilerDriver driver = {0};
+	if (options->output_path == NULL) {
+		Output_InitStandard(&driver.sink, OUTPUT_STDERR);
+	}
+	else if (!Output_OpenFile(&driver.sink, options->output_path)) {
+		LOG_ERROR("Couldn't open output file %s\n", options->output_path);
+		Profile_End(&compile_scope);
+		return options->input_count;
+	}
+
+	/* the calling thread works through the queue as well while it waits */
+	ThreadPool* pool = ThreadPool_Create(thread_count - 1);
+	U32 worker_slots = ThreadPool_GetWorkerSlots(pool);
+
+	driver.options = options;
+	driver.pool = pool;
+	driver.jobs = Malloc(options->input_count * sizeof(*driver.jobs));
+	driver.worker_arenas = Malloc(worker_slots * sizeof(*driver.worker_arenas));
+	driver.symbol_arenas = Malloc(worker_slots * sizeof(*driver.symbol_arenas));
+	driver.output_mutex = Mutex_Create();
+
+	/*
+		A block the size of L2 keeps a file's scanner and parser allocations in
+		few blocks without every worker reserving more than its share of cache.
+	*/
+	Size_t block_size = cpu_info->l2_cache_size;
+	if (block_size < ARENA_DEFAULT_BLOCK_SIZE) block_size = ARENA_DEFAULT_BLOCK_SIZE;
+	if (block_size > 4 * 1024 * 1024) block_size = 4 * 1024 * 1024;
+
+	for (U32 i = 0; i < worker_slots; i++) {
+		driver.worker_arenas[i] = Arena_Create(block_size);
+		driver.symbol_arenas[i] = Arena_Create(ARENA_DEFAULT_BLOCK_SIZE);
+	}
+
+	/* every job is set up before any runs, a finishing job looks at its successors */
+	for (U32 i = 0; i < options->input_count; i++) {
+		CompilerJob* job = &driver.jobs[i];
+		job->driver = &driver;
+		job->file_path = StrView_FromCString(options->input_paths[i]);
+		job->finished = FALSE;
+		job->failed = FALSE;
+		Output_InitMemory(&job->output);
+	}
+
+	JobGroup group = {0};
+	for (U32 i = 0; i < options->input_count; i++) {
+		ThreadPool_Submit(pool, &group, CompilerFileJob, &driver.jobs[i]);
+	}
+	ThreadPool_Wait(pool, &group);
+
+	ThreadPool_Destroy(pool);
+	for (U32 i = 0; i < worker_slots; i++) {
+		Arena_Destroy(driver.worker_arenas[i]);
+		Arena_Destroy(driver.symbol_arenas[i]);
+	}
+	Mutex_Destroy(driver.output_mutex);
+	Free(driver.worker_arenas);
+	Free(driver.symbol_arenas);
+	Free(driver.jobs);
+
+	/* a failed write loses output of files that compiled fine, count it against the run */
+	if (!Output_Close(&driver.sink)) {
+		LOG_ERROR("Couldn't write compiler output\n");
+		if (driver.failed_count == 0) driver.failed_count = 1;
+	}
+	Profile_End(&compile_scope);
+
+	return driver.failed_count;
+}
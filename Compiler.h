@@ -1,10 +1,48 @@
 #pragma once
 
-#include "Array.h"
+#include "Token.h"
+#include "Memory.h"
+#include "Intern.h"
+#include "Ast.h"
+#include "Output.h"
+#include "String.h"
+#include "CPU.h"
+#include "ThreadPool.h"
+#include "LineIndex.h"
+
+/* Files at least this big are tokenized in parallel chunks */
+#define COMPILER_PARALLEL_SCAN_THRESHOLD (8 * 1024 * 1024)
+
+typedef struct compileroptions_t {
+	const char** input_paths;
+	U32 input_count;
+	U32 thread_count;       // 0 sizes the pool from CPUInfo.number_of_processors
+	Bool dump_tokens;
+	Bool dump_ast;
+	Bool parallel_scan;     // chunk every file regardless of COMPILER_PARALLEL_SCAN_THRESHOLD
+	Bool pipeline_scan;     // scan on a dedicated thread while the file is consumed, wins over parallel_scan
+	const char* output_path;    // dumps and diagnostics, NULL for stderr
+} CompilerOptions;
 
 typedef struct compiler_t {
-	U8* rData;
-	Array_Type tokens;
+	StrView file_path;      // NUL-terminated as well, it comes from the command line
+	StrView source;         // the file's bytes, source.ptr[source.len] is the NUL terminator
+	TokenBuffer* tokens;
+	Interner* interner;
+	Ast ast;                // nodes and lists live in arena
+	Arena* arena;           // owns every allocation that lives as long as the compilation
+	Arena* symbol_arena;    // interned names only, the pipeline's scanner thread fills it while the parser uses arena
+	ThreadPool* pool;
+	Output* output;         // memory sink for diagnostics and dumps, emitted in input order once the file is done
+	LineIndex lines;        // built in arena by the first diagnostic
+	U32 error_count;
 } CompilerInfo;
 
-void CompilerMain(const char* file_path);
\ No newline at end of file
+/* Compiles every input on a worker pool and returns the number of files that failed */
+U32 CompilerMain(const CompilerOptions* options, const CPUInfo* cpu_info);
+
+/* Reports an error at a byte offset of the source, printed as file:line:column */
+void CompilerError(CompilerInfo* info, U32 offset, const char* fmt, ...);
+void CompilerErrorV(CompilerInfo* info, U32 offset, const char* fmt, va_list args);
+/* Reports the ScannerError an ILLEGAL token of info->tokens carries */
+void CompilerReportIllegalToken(CompilerInfo* info, U32 token);
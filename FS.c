@@ -1,13 +1,43 @@
 #include "FS.h"
 #include "FS_Win32.h"
+#include "FS_Linux.h"
 
-U8* FS_ReadFile(const char* path) {
+U8* FS_ReadFile(const char* path, Size_t* size) {
 	U8* data = NULL;
+	*size = 0;
 #ifdef _WIN32
-	data = Win32_ReadFile(path);
+	data = Win32_ReadFile((const U8*)path, size);
+#elif defined(__linux__)
+	data = Linux_ReadFile((const U8*)path, size);
 #endif
 	return data;
 }
 
-Bool FS_WriteFile(const char* path, const char* buffer, Size_t size){}
-Bool FS_FileExists(const char* path) {}
\ No newline at end of file
+void FS_FreeFile(U8* data, Size_t size) {
+	if (data == NULL) return;
+#ifdef _WIN32
+	Win32_FreeFile(data, size);
+#elif defined(__linux__)
+	Linux_FreeFile(data, size);
+#endif
+}
+
+Bool FS_WriteFile(const char* path, const char* buffer, Size_t size){
+	Bool success = FALSE;
+#ifdef _WIN32
+	success = Win32_WriteFile((const U8*)path, (const U8*)buffer, size);
+#elif defined(__linux__)
+	success = Linux_WriteFile((const U8*)path, (const U8*)buffer, size);
+#endif
+	return success;
+}
+
+Bool FS_FileExists(const char* path) {
+	Bool exists = FALSE;
+#ifdef _WIN32
+	exists = Win32_FileExists((const U8*)path);
+#elif defined(__linux__)
+	exists = Linux_FileExists((const U8*)path);
+#endif
+	return exists;
+}
\ No newline at end of file
@@ -2,7 +2,12 @@
 
 #include "Common.h"
 
-U8* FS_ReadFile(const char* path);
+/*
+	Returns a read-only, NUL-terminated view of the file and stores its length
+	(without the terminator) in size. The buffer must be released with FS_FreeFile.
+*/
+U8* FS_ReadFile(const char* path, Size_t* size);
+void FS_FreeFile(U8* data, Size_t size);
 
 Bool FS_WriteFile(const char* path, const char* buffer, Size_t size);
-Bool FS_FileExists(const char* path);
\ No newline at end of file
+Bool FS_FileExists(const char* path);
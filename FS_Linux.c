@@ -0,0 +1,91 @@
+#ifdef __linux__
+#include "FS_Linux.h"
+#include "Logger.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static Size_t PageRoundUp(Size_t size) {
+    Size_t page_size = (Size_t)sysconf(_SC_PAGESIZE);
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+/*
+    The file is mapped read-only instead of being copied into a heap buffer.
+    We first reserve a zeroed anonymous region one byte larger than the file and
+    then map the file over the front of it, so the byte after the last character
+    is always a NUL terminator, even when the file size is a multiple of the page size.
+*/
+U8* Linux_ReadFile(const U8* path, Size_t* size) {
+    int fd = open((const char*)path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open file\n");
+        return NULL;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0 || !S_ISREG(file_stat.st_mode)) {
+        LOG_ERROR("Failed to stat file or file is not a regular file\n");
+        close(fd);
+        return NULL;
+    }
+
+    Size_t file_size = (Size_t)file_stat.st_size;
+    Size_t map_size = PageRoundUp(file_size + 1);
+
+    U8* region = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        LOG_ERROR("Couldn't reserve mapping for file\n");
+        close(fd);
+        return NULL;
+    }
+
+    if (file_size > 0) {
+        void* mapped = mmap(region, file_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            LOG_ERROR("Failed to map file\n");
+            munmap(region, map_size);
+            close(fd);
+            return NULL;
+        }
+        madvise(region, file_size, MADV_SEQUENTIAL);
+    }
+
+    close(fd);
+
+    *size = file_size;
+    return region;
+}
+
+void Linux_FreeFile(U8* data, Size_t size) {
+    munmap(data, PageRoundUp(size + 1));
+}
+
+Bool Linux_WriteFile(const U8* path, const U8* buffer, Size_t size) {
+    int fd = open((const char*)path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open file for writing\n");
+        return FALSE;
+    }
+
+    Size_t written = 0;
+    while (written < size) {
+        ssize_t result = write(fd, buffer + written, size - written);
+        if (result < 0) {
+            LOG_ERROR("Failed to write file\n");
+            close(fd);
+            return FALSE;
+        }
+        written += (Size_t)result;
+    }
+
+    close(fd);
+    return TRUE;
+}
+
+Bool Linux_FileExists(const U8* path) {
+    return access((const char*)path, F_OK) == 0;
+}
+#endif
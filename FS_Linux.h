@@ -0,0 +1,8 @@
+#pragma once
+#include "Common.h"
+
+U8*  Linux_ReadFile(const U8* path, Size_t* size);
+void Linux_FreeFile(U8* data, Size_t size);
+
+Bool Linux_WriteFile(const U8* path, const U8* buffer, Size_t size);
+Bool Linux_FileExists(const U8* path);
@@ -3,7 +3,7 @@
 #include "Memory.h"
 #include "windows.h"
 
-U8* Win32_ReadFile(const U8* path) {
+U8* Win32_ReadFile(const U8* path, Size_t* size) {
     HANDLE hFile;
     DWORD bytesRead, fileSize;
     BOOL success;
@@ -51,14 +51,51 @@ U8* Win32_ReadFile(const U8* path) {
     }
 
     buffer[bytesRead] = '\0';
+    *size = bytesRead;
 
     CloseHandle(hFile);
 
     return buffer;
 }
 
+void Win32_FreeFile(U8* data, Size_t size) {
+    Free(data);
+}
+
 Bool Win32_WriteFile(const U8* path, const U8* buffer, Size_t size) {
+    HANDLE hFile = CreateFileA(
+        (const char*)path,
+        GENERIC_WRITE,
+        0,
+        NULL,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL
+    );
 
+    if (hFile == INVALID_HANDLE_VALUE) {
+        LOG_ERROR("Failed to open file for writing. Error: %lu\n", GetLastError());
+        return FALSE;
+    }
+
+    /* WriteFile takes a DWORD count, bigger buffers go out in pieces */
+    Size_t written = 0;
+    while (written < size) {
+        Size_t remaining = size - written;
+        DWORD chunk = remaining > 0x40000000 ? 0x40000000 : (DWORD)remaining;
+        DWORD bytesWritten = 0;
+        if (!WriteFile(hFile, buffer + written, chunk, &bytesWritten, NULL)) {
+            LOG_ERROR("Failed to write file. Error: %lu\n", GetLastError());
+            CloseHandle(hFile);
+            return FALSE;
+        }
+        written += bytesWritten;
+    }
+
+    CloseHandle(hFile);
+    return TRUE;
 }
 
-Bool Win32_FileExists(const U8* path) {}
\ No newline at end of file
+Bool Win32_FileExists(const U8* path) {
+    return GetFileAttributesA((const char*)path) != INVALID_FILE_ATTRIBUTES;
+}
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 #include "Common.h"
 
-U8*  Win32_ReadFile(const U8* path);
+U8*  Win32_ReadFile(const U8* path, Size_t* size);
+void Win32_FreeFile(U8* data, Size_t size);
 
 Bool Win32_WriteFile(const U8* path, const U8* buffer, Size_t size);
 Bool Win32_FileExists(const U8* path);
\ No newline at end of file
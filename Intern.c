@@ -0,0 +1,100 @@
+#include "Intern.h"
+#include "Logger.h"
+#include "String.h"
+
+static U32 RoundUpPowerOfTwo(U32 value) {
+	U32 result = 16;
+	while (result < value) result <<= 1;
+	return result;
+}
+
+Interner* Interner_Create(Arena* arena, U32 expected_symbols) {
+	Interner* interner = Malloc(sizeof(*interner));
+	if (interner == NULL) return NULL;
+
+	/* keep the load factor at or below one half */
+	U32 slot_count = RoundUpPowerOfTwo(expected_symbols * 2);
+	InternEntryVec_Init(&interner->entries);
+	InternConstantVec_Init(&interner->constants);
+	interner->slots = Malloc(slot_count * sizeof(*interner->slots));
+	if (interner->slots == NULL) {
+		Interner_Destroy(interner);
+		return NULL;
+	}
+	InternEntryVec_Reserve(&interner->entries, slot_count / 2);
+
+	for (U32 i = 0; i < slot_count; i++) interner->slots[i] = 0;
+	interner->slot_mask = slot_count - 1;
+	interner->arena = arena;
+	return interner;
+}
+
+static void InternerGrow(Interner* interner) {
+	U32 slot_count = (interner->slot_mask + 1) * 2;
+	U32* slots = Malloc(slot_count * sizeof(*slots));
+	if (slots == NULL) {
+		PANIC("Malloc Failed");
+	}
+	for (U32 i = 0; i < slot_count; i++) slots[i] = 0;
+
+	U32 mask = slot_count - 1;
+	for (U32 symbol = 0; symbol < interner->entries.count; symbol++) {
+		U32 index = interner->entries.data[symbol].hash & mask;
+		while (slots[index] != 0) index = (index + 1) & mask;
+		slots[index] = symbol + 1;
+	}
+
+	Free(interner->slots);
+	interner->slots = slots;
+	interner->slot_mask = mask;
+	InternEntryVec_Reserve(&interner->entries, slot_count / 2);
+}
+
+static Bool EntryMatches(const InternEntry* entry, U32 hash, StrView name) {
+	if (entry->hash != hash) return FALSE;
+	return StrView_Equal(entry->name, name);
+}
+
+U32 Interner_Intern(Interner* interner, StrView name) {
+	U32 hash = StrView_Hash(name);
+	U32 index = hash & interner->slot_mask;
+
+	for (;;) {
+		U32 slot = interner->slots[index];
+		if (slot == 0) break;
+		if (EntryMatches(&interner->entries.data[slot - 1], hash, name)) {
+			return slot - 1;
+		}
+		index = (index + 1) & interner->slot_mask;
+	}
+
+	/* keep the load factor at or below one half */
+	if (interner->entries.count >= (interner->slot_mask + 1) / 2) {
+		InternerGrow(interner);
+		/* the table got rehashed, find the new empty slot */
+		index = hash & interner->slot_mask;
+		while (interner->slots[index] != 0) index = (index + 1) & interner->slot_mask;
+	}
+
+	U8* copy = Arena_Alloc(interner->arena, name.len + 1, 1);
+	Memcpy(copy, name.ptr, name.len);
+	copy[name.len] = '\0';
+
+	U32 symbol = interner->entries.count;
+	InternEntryVec_Push(&interner->entries, (InternEntry) {.name= StrView_Make(copy, name.len), .hash= hash});
+	interner->slots[index] = symbol + 1;
+	return symbol;
+}
+
+StrView Interner_GetName(const Interner* interner, U32 symbol) {
+	if (symbol >= interner->entries.count) return StrView_Make(NULL, 0);
+	return interner->entries.data[symbol].name;
+}
+
+void Interner_Destroy(Interner* interner) {
+	if (interner == NULL) return;
+	Free(interner->slots);
+	InternEntryVec_Free(&interner->entries);
+	InternConstantVec_Free(&interner->constants);
+	Free(interner);
+}
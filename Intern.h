@@ -0,0 +1,49 @@
+#pragma once
+#include "Common.h"
+#include "Memory.h"
+#include "Vec.h"
+#include "String.h"
+
+#define INTERN_INVALID_SYMBOL 0xFFFFFFFF
+
+typedef struct internentry_t {
+	StrView name;           // copy living in the arena, NUL-terminated past len
+	U32 hash;
+} InternEntry;
+
+DEFINE_VEC(InternEntry)
+DEFINE_VEC_NAMED(InternConstantVec, U64)
+
+/*
+	Maps identifier bytes to dense symbol ids (0, 1, 2, ...).
+	The hash table is open-addressed with linear probing and stores symbol + 1,
+	so a zeroed slot is empty. Each unique name is copied into the arena once.
+
+	The interner also keeps the file's numeric constants, the 64-bit values a
+	token's U32 value can't hold. Every scan already carries an interner and
+	the constants follow the same ownership rules as the names.
+*/
+typedef struct interner_t {
+	U32* slots;
+	U32 slot_mask;          // slot count - 1, slot count is a power of two
+	InternEntryVec entries; // indexed by symbol, entries.count is the number of symbols
+	InternConstantVec constants;    // number literal values in scan order, not deduplicated
+	Arena* arena;
+} Interner;
+
+Interner* Interner_Create(Arena* arena, U32 expected_symbols);
+U32 Interner_Intern(Interner* interner, StrView name);
+/* An empty view for an unknown symbol */
+StrView Interner_GetName(const Interner* interner, U32 symbol);
+void Interner_Destroy(Interner* interner);
+
+/* Appends a constant and returns its index */
+static inline U32 Interner_AddConstant(Interner* interner, U64 value) {
+	U32 index = interner->constants.count;
+	InternConstantVec_Push(&interner->constants, value);
+	return index;
+}
+
+static inline U64 Interner_GetConstant(const Interner* interner, U32 index) {
+	return interner->constants.data[index];
+}
@@ -0,0 +1,54 @@
+#include "Keyword.h"
+#include "String.h"
+#include "Logger.h"
+
+typedef struct keyword_t {
+	StrView spelling;
+	U8 kind;
+} KeywordEntry;
+
+#define KEYWORD_ENTRY(kind, spelling, first, last) \
+	[KEYWORD_HASH(sizeof(spelling) - 1, first, last)] = { STRVIEW_INIT(spelling), kind },
+
+static const KeywordEntry KeywordTable[KEYWORD_TABLE_SIZE] = {
+	KEYWORD_LIST(KEYWORD_ENTRY)
+};
+
+/* The lengths the lookup accepts are constants, KEYWORD_MIN_LENGTH and KEYWORD_MAX_LENGTH have to cover every spelling */
+#define KEYWORD_CHECK_LENGTH(kind, spelling, first, last) \
+	_Static_assert(sizeof(spelling) - 1 >= KEYWORD_MIN_LENGTH && sizeof(spelling) - 1 <= KEYWORD_MAX_LENGTH, \
+		"KEYWORD_MIN_LENGTH or KEYWORD_MAX_LENGTH excludes " spelling);
+
+KEYWORD_LIST(KEYWORD_CHECK_LENGTH)
+
+/*
+	Two keywords hashing to the same slot become a duplicate case label, i.e. a
+	compile error instead of a keyword that silently scans as an identifier.
+	Indexing a string literal isn't a constant expression, so the spelled out
+	characters can only be checked at run time: every keyword has to look up
+	as itself, which also fails if a character disagrees with the spelling.
+*/
+#define KEYWORD_CASE(kind, spelling, first, last) \
+	case KEYWORD_HASH(sizeof(spelling) - 1, first, last): break;
+
+#define KEYWORD_CHECK_LOOKUP(kind, spelling, first, last) \
+	if (KeywordLookup(STRVIEW(spelling)) != kind) { \
+		PANIC("Keyword.h: \"%s\" doesn't look up as a keyword, check its first and last characters", spelling); \
+	}
+
+void KeywordCheckList(void) {
+	switch (KEYWORD_TABLE_SIZE) {
+		KEYWORD_LIST(KEYWORD_CASE)
+		default: break;
+	}
+	KEYWORD_LIST(KEYWORD_CHECK_LOOKUP)
+}
+
+TokenKind KeywordLookup(StrView literal) {
+	if (literal.len < KEYWORD_MIN_LENGTH || literal.len > KEYWORD_MAX_LENGTH) return TOKEN_IDENTIFIER;
+
+	const KeywordEntry* entry = &KeywordTable[KEYWORD_HASH(literal.len, literal.ptr[0], literal.ptr[literal.len - 1])];
+	if (!StrView_Equal(literal, entry->spelling)) return TOKEN_IDENTIFIER;
+
+	return (TokenKind)entry->kind;
+}
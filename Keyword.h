@@ -0,0 +1,32 @@
+#pragma once
+#include "Token.h"
+#include "String.h"
+
+/*
+	The one keyword list. Every other keyword table is generated from it.
+	X(kind, spelling, first character, last character)
+	The characters are spelled out because string indexing isn't a constant
+	expression in C, they feed the perfect hash below.
+*/
+#define KEYWORD_LIST(X)                   \
+	X(TOKEN_FUNC,  "func",  'f', 'c')     \
+	X(TOKEN_IF,    "if",    'i', 'f')     \
+	X(TOKEN_ELSE,  "else",  'e', 'e')     \
+	X(TOKEN_FOR,   "for",   'f', 'r')     \
+	X(TOKEN_WHILE, "while", 'w', 'e')
+
+#define KEYWORD_TABLE_SIZE 32
+#define KEYWORD_MIN_LENGTH 2
+#define KEYWORD_MAX_LENGTH 5
+
+/*
+	Collision-free for the list above, Keyword.c refuses to compile if a new
+	keyword collides, in which case the mixing or the table size has to change.
+*/
+#define KEYWORD_HASH(length, first, last) \
+	(((U32)(length) + (U32)(first) + (U32)(last)) & (KEYWORD_TABLE_SIZE - 1))
+
+/* Returns the keyword's token kind, or TOKEN_IDENTIFIER if the span isn't a keyword */
+TokenKind KeywordLookup(StrView literal);
+/* Startup check of KEYWORD_LIST, the parts of it the compiler can't check itself */
+void KeywordCheckList(void);
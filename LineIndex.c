@@ -0,0 +1,31 @@
+#include "LineIndex.h"
+
+void LineIndex_Build(LineIndex* index, StrView source, Arena* arena) {
+	/* counting first sizes the table exactly, both passes are vector-wide */
+	U32 count = (U32)StringCountByte(source.ptr, '\n', source.len) + 1;
+	U32* starts = ARENA_PUSH_ARRAY(arena, U32, count);
+
+	starts[0] = 0;
+	const U8* cursor = source.ptr;
+	const U8* end = source.ptr + source.len;
+	for (U32 line = 1; line < count; line++) {
+		const U8* newline = StringFindByte(cursor, '\n', (Size_t)(end - cursor));
+		starts[line] = (U32)(newline - source.ptr) + 1;
+		cursor = newline + 1;
+	}
+
+	index->starts = starts;
+	index->count = count;
+}
+
+SourcePosition LineIndex_Resolve(const LineIndex* index, U32 offset) {
+	/* the last line starting at or before offset */
+	U32 low = 0;
+	U32 high = index->count;
+	while (high - low > 1) {
+		U32 middle = low + (high - low) / 2;
+		if (index->starts[middle] <= offset) low = middle;
+		else high = middle;
+	}
+	return (SourcePosition) {.line= low + 1, .column= offset - index->starts[low] + 1};
+}
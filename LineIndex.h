@@ -0,0 +1,25 @@
+#pragma once
+#include "Common.h"
+#include "Memory.h"
+#include "String.h"
+
+/*
+	Tokens only carry byte offsets, lines and columns are worked out when a
+	diagnostic needs one. The index is the offset of every line's first byte,
+	built in one go from a vectorized newline count and search, a position is
+	then a binary search away. A compilation without diagnostics never builds it.
+*/
+typedef struct lineindex_t {
+	U32* starts;            // starts[0] is 0, one entry per line, NULL until built
+	U32 count;
+} LineIndex;
+
+/* 1-based, the column counts bytes */
+typedef struct sourceposition_t {
+	U32 line;
+	U32 column;
+} SourcePosition;
+
+/* starts comes from arena */
+void LineIndex_Build(LineIndex* index, StrView source, Arena* arena);
+SourcePosition LineIndex_Resolve(const LineIndex* index, U32 offset);
@@ -2,32 +2,257 @@
 #include "Logger.h"
 #include "String.h"
 #include "Memory.h"
+#include "Thread.h"
+#include "Atomic.h"
 
-static char* ConvertLogTypeToString(Log_Type type) {
-	char* tmp = "";
-	switch (type) {
-	case LOG_INFO:
-		tmp = "INFO";
-		break;
-	case LOG_ERROR:
-		tmp = "ERROR";
-		break;
-	case LOG_WARNING:
-		tmp = "WARNING";
-		break;
-	}
-
-	U32 length = GetStringLength(tmp);
-	
-	char* tmp_buffer = Malloc(sizeof(*tmp_buffer) * (length + 1));
-	Memcpy(tmp_buffer, tmp, length);
-	tmp_buffer[length] = '\0';
-	
-	return tmp_buffer;
-}
-
-void Log(Log_Type type, const char* fmt) {
-	char* buffer = ConvertLogTypeToString(type);
-	Print("[%s] %s", buffer, fmt);
-	Free(buffer);
-}
\ No newline at end of file
+#include <stdio.h>
+
+#define LOGGER_RING_SIZE   1024                 // power of two
+#define LOGGER_RING_MASK   (LOGGER_RING_SIZE - 1)
+#define LOGGER_RECORD_SIZE 256
+#define LOGGER_TEXT_SIZE   (LOGGER_RECORD_SIZE - 2 * sizeof(U32))
+#define LOGGER_BATCH_SIZE  (16 * 1024)
+
+/*
+	A slot is free for position p when sequence == p and holds a published
+	record when sequence == p + 1. The writer hands it back for the next lap
+	by setting it to p + LOGGER_RING_SIZE.
+*/
+typedef struct logrecord_t {
+	volatile U32 sequence;
+	U32 length;
+	char text[LOGGER_TEXT_SIZE];
+} LogRecord;
+
+static LogRecord g_logRing[LOGGER_RING_SIZE];
+/* producers and the writer hammer different counters, keep them on separate lines */
+static AtomicPaddedU32 g_logEnqueue;    // next position a producer claims
+static AtomicPaddedU32 g_logDequeue;    // next position the writer reads, advanced once the text is out
+static AtomicPaddedU32 g_logProducers;  // producers between seeing g_logRunning and publishing
+static volatile U32 g_logRunning;
+static volatile U32 g_logSleeping;
+static Thread* g_logThread;
+static Mutex* g_logMutex;
+static CondVar* g_logWake;
+
+static const StrView LogTypePrefixTable[LOG_TYPE_COUNT] = {
+	[LOG_INFO] = STRVIEW_INIT("[INFO] "),
+	[LOG_WARNING] = STRVIEW_INIT("[WARNING] "),
+	[LOG_ERROR] = STRVIEW_INIT("[ERROR] "),
+};
+
+/* Copies the level prefix, the prefixes are far shorter than a record */
+static U32 LoggerWritePrefix(char* out, Log_Type type) {
+	StrView prefix = LogTypePrefixTable[type];
+	Memcpy(out, prefix.ptr, prefix.len);
+	return prefix.len;
+}
+
+/* mark the cut so a truncated record isn't mistaken for the whole message */
+static U32 LoggerTruncate(char* out, U32 capacity) {
+	Memcpy(out + capacity - 5, "...\n", 4);
+	return capacity - 1;
+}
+
+static U32 LoggerFormat(char* out, U32 capacity, Log_Type type, const char* fmt, va_list args) {
+	U32 prefix = LoggerWritePrefix(out, type);
+	int length = vsnprintf(out + prefix, capacity - prefix, fmt, args);
+	if (length < 0) length = 0;
+
+	U32 total = prefix + (U32)length;
+	if (total >= capacity) total = LoggerTruncate(out, capacity);
+	return total;
+}
+
+static U32 LoggerCopy(char* out, U32 capacity, Log_Type type, StrView message) {
+	U32 prefix = LoggerWritePrefix(out, type);
+	if (prefix + message.len >= capacity) {
+		Memcpy(out + prefix, message.ptr, capacity - prefix);
+		return LoggerTruncate(out, capacity);
+	}
+	Memcpy(out + prefix, message.ptr, message.len);
+	return prefix + message.len;
+}
+
+static void LoggerWake(void) {
+	Mutex_Lock(g_logMutex);
+	CondVar_Signal(g_logWake);
+	Mutex_Unlock(g_logMutex);
+}
+
+static void LoggerWriterMain(void* arg) {
+	(void)arg;
+	static char batch[LOGGER_BATCH_SIZE];
+	U32 position = g_logDequeue.value;
+	Bool draining = FALSE;
+
+	for (;;) {
+		/* gather as many records as fit and write them with one call */
+		U32 size = 0;
+		while (size + LOGGER_TEXT_SIZE <= LOGGER_BATCH_SIZE) {
+			LogRecord* record = &g_logRing[position & LOGGER_RING_MASK];
+			if (Atomic_LoadU32(&record->sequence) != position + 1) break;
+
+			Memcpy(batch + size, record->text, record->length);
+			size += record->length;
+			Atomic_StoreU32(&record->sequence, position + LOGGER_RING_SIZE);
+			position++;
+		}
+		if (size != 0) {
+			Print("%.*s", (int)size, batch);
+			Atomic_StoreU32(&g_logDequeue.value, position);
+			continue;
+		}
+		if (!Atomic_LoadU32(&g_logRunning)) {
+			/* a producer that saw the flag before it dropped may still publish, take one more pass once none are left */
+			if (draining) break;
+			Atomic_Fence();
+			if (Atomic_LoadU32(&g_logProducers.value) == 0) draining = TRUE;
+			else Thread_Yield();
+			continue;
+		}
+
+		/* announce the sleep before the last look, producers check the flag after publishing */
+		Mutex_Lock(g_logMutex);
+		Atomic_StoreU32(&g_logSleeping, 1);
+		Atomic_Fence();
+		LogRecord* next = &g_logRing[position & LOGGER_RING_MASK];
+		if (Atomic_LoadU32(&next->sequence) != position + 1 && Atomic_LoadU32(&g_logRunning)) {
+			CondVar_Wait(g_logWake, g_logMutex);
+		}
+		Atomic_StoreU32(&g_logSleeping, 0);
+		Mutex_Unlock(g_logMutex);
+	}
+}
+
+void Logger_Init(void) {
+	if (g_logThread != NULL) return;
+
+	for (U32 i = 0; i < LOGGER_RING_SIZE; i++) {
+		g_logRing[i].sequence = i;
+	}
+	g_logEnqueue.value = 0;
+	g_logDequeue.value = 0;
+	g_logProducers.value = 0;
+	g_logMutex = Mutex_Create();
+	g_logWake = CondVar_Create();
+	Atomic_StoreU32(&g_logRunning, 1);
+
+	g_logThread = Thread_Create(LoggerWriterMain, NULL);
+	if (g_logThread == NULL) {
+		/* stay synchronous, records would never be drained */
+		Atomic_StoreU32(&g_logRunning, 0);
+	}
+}
+
+void Logger_Flush(void) {
+	if (!Atomic_LoadU32(&g_logRunning)) return;
+
+	U32 target = Atomic_LoadU32(&g_logEnqueue.value);
+	while ((S32)(Atomic_LoadU32(&g_logDequeue.value) - target) < 0) {
+		LoggerWake();
+		Thread_Yield();
+	}
+}
+
+void Logger_Shutdown(void) {
+	if (g_logThread == NULL) return;
+
+	Logger_Flush();
+	Atomic_StoreU32(&g_logRunning, 0);
+	LoggerWake();
+	Thread_Join(g_logThread);
+
+	g_logThread = NULL;
+	CondVar_Destroy(g_logWake);
+	Mutex_Destroy(g_logMutex);
+}
+
+/* Claims a slot, a full ring makes producers wait for the writer rather than drop records */
+static LogRecord* LoggerClaim(U32* claimed) {
+	U32 position = Atomic_LoadU32(&g_logEnqueue.value);
+	LogRecord* record;
+	for (;;) {
+		record = &g_logRing[position & LOGGER_RING_MASK];
+		S32 distance = (S32)(Atomic_LoadU32(&record->sequence) - position);
+		if (distance == 0) {
+			if (Atomic_CompareExchangeU32(&g_logEnqueue.value, position, position + 1)) break;
+		}
+		else if (distance < 0) {
+			LoggerWake();
+			Thread_Yield();
+		}
+		position = Atomic_LoadU32(&g_logEnqueue.value);
+	}
+
+	*claimed = position;
+	return record;
+}
+
+/* Registers a producer for the ring, FALSE when the writer is gone or going and the caller should print itself */
+static Bool LoggerEnter(void) {
+	Atomic_AddU32(&g_logProducers.value, 1);
+	if (Atomic_LoadU32(&g_logRunning)) return TRUE;
+	Atomic_AddU32(&g_logProducers.value, (U32)-1);
+	return FALSE;
+}
+
+static void LoggerPublish(LogRecord* record, U32 position) {
+	Atomic_StoreU32(&record->sequence, position + 1);
+
+	Atomic_Fence();
+	if (Atomic_LoadU32(&g_logSleeping)) {
+		LoggerWake();
+	}
+	/* last, the writer must outlive the wake */
+	Atomic_AddU32(&g_logProducers.value, (U32)-1);
+}
+
+void LogV(Log_Type type, const char* fmt, va_list args) {
+	if (!LoggerEnter()) {
+		char text[LOGGER_TEXT_SIZE];
+		U32 length = LoggerFormat(text, sizeof(text), type, fmt, args);
+		Print("%.*s", (int)length, text);
+		return;
+	}
+
+	U32 position;
+	LogRecord* record = LoggerClaim(&position);
+	record->length = LoggerFormat(record->text, sizeof(record->text), type, fmt, args);
+	LoggerPublish(record, position);
+}
+
+void LogView(Log_Type type, StrView message) {
+	if (!LoggerEnter()) {
+		char text[LOGGER_TEXT_SIZE];
+		U32 length = LoggerCopy(text, sizeof(text), type, message);
+		Print("%.*s", (int)length, text);
+		return;
+	}
+
+	U32 position;
+	LogRecord* record = LoggerClaim(&position);
+	record->length = LoggerCopy(record->text, sizeof(record->text), type, message);
+	LoggerPublish(record, position);
+}
+
+void Log(Log_Type type, const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	LogV(type, fmt, args);
+	va_end(args);
+}
+
+void Logger_Panic(const char* file, int line, const char* fmt, ...) {
+	/* whatever was logged before the panic usually explains it */
+	Logger_Flush();
+
+	char text[LOGGER_TEXT_SIZE];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(text, sizeof(text), fmt, args);
+	va_end(args);
+
+	Print("[%s, %d]: %s\n", file, line, text);
+	exit(1);
+}
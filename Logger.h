@@ -1,4 +1,7 @@
 #pragma once
+#include "Common.h"
+#include "String.h"
+#include <stdlib.h>
 
 typedef enum {
 	LOG_INFO,
@@ -7,25 +10,54 @@ typedef enum {
 	LOG_TYPE_COUNT,
 } Log_Type;
 
-void Log(Log_Type type, const char* fmt);
+/*
+	Records are formatted by the caller into a lock-free ring and written out by a
+	background thread, so logging from workers never waits on stderr. Before
+	Logger_Init (and after Logger_Shutdown) Log writes synchronously.
+*/
+void Logger_Init(void);
+/* Blocks until every record logged before the call has been written */
+void Logger_Flush(void);
+void Logger_Shutdown(void);
+
+void Log(Log_Type type, const char* fmt, ...);
+void LogV(Log_Type type, const char* fmt, va_list args);
+/* Logs message as is, without printf parsing. Format views elsewhere with STRVIEW_FMT / STRVIEW_ARG */
+void LogView(Log_Type type, StrView message);
+
+/* Flushes the log, prints the message and exits */
+void Logger_Panic(const char* file, int line, const char* fmt, ...);
+
+/* Levels below the threshold compile to nothing, e.g. -DLOG_LEVEL_THRESHOLD=2 keeps errors only */
+#define LOG_LEVEL_INFO    0
+#define LOG_LEVEL_WARNING 1
+#define LOG_LEVEL_ERROR   2
+
+#ifndef LOG_LEVEL_THRESHOLD
+#define LOG_LEVEL_THRESHOLD LOG_LEVEL_INFO
+#endif
 
 #ifndef LOG_FUNCTIONS
 #define LOG_FUNCTIONS
 
-#define LOG_INFO(msg) Log(LOG_INFO, msg)
-#define LOG_WARNING(msg) Log(LOG_WARNING, msg)
-#define LOG_ERROR(msg) Log(LOG_ERROR, msg)
+#if LOG_LEVEL_THRESHOLD <= LOG_LEVEL_INFO
+#define LOG_INFO(...) Log(LOG_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_LEVEL_THRESHOLD <= LOG_LEVEL_WARNING
+#define LOG_WARNING(...) Log(LOG_WARNING, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) ((void)0)
+#endif
+
+#if LOG_LEVEL_THRESHOLD <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) Log(LOG_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
 
 #endif
 
-static void panic(const char* msg, const char* file, int line, ...) {
-	Print("[%s, %d]: ", file, line);
-	va_list args;
-	va_start(args, line);
-	Print(msg, args);
-	va_end(args);
-	Print("\n");
-	exit(1);
-}
-
-#define PANIC(msg, ...) panic(msg,__FILE__, __LINE__, ##__VA_ARGS__ ) 
\ No newline at end of file
+#define PANIC(...) Logger_Panic(__FILE__, __LINE__, __VA_ARGS__)
@@ -1,23 +1,186 @@
 #include "Logger.h"
 #include "Compiler.h"
+#include "CPU.h"
+#include "Scanner.h"
+#include "ScannerKernels.h"
+#include "Keyword.h"
+#include "StringKernels.h"
+#include "Memory.h"
+#include "FS.h"
+#include "String.h"
+#include "Profile.h"
+#include "Vec.h"
 
+DEFINE_VEC_NAMED(PathVec, const char*)
+
+static Bool IsSeparator(U8 c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/* A response file lists input paths separated by whitespace, the copies live in arena */
+static Bool ReadResponseFile(PathVec* inputs, const char* path, Arena* arena) {
+	Size_t size = 0;
+	U8* data = FS_ReadFile(path, &size);
+	if (data == NULL) return FALSE;
+
+	Size_t cursor = 0;
+	while (cursor < size) {
+		while (cursor < size && IsSeparator(data[cursor])) cursor++;
+		Size_t start = cursor;
+		while (cursor < size && !IsSeparator(data[cursor])) cursor++;
+		if (cursor == start) break;
+
+		Size_t length = cursor - start;
+		char* input = Arena_Alloc(arena, length + 1, 1);
+		Memcpy(input, data + start, length);
+		input[length] = '\0';
+		PathVec_Push(inputs, input);
+	}
+
+	FS_FreeFile(data, size);
+	return TRUE;
+}
+
+/* A thread count, FALSE if text is empty, has anything but digits or doesn't fit */
+static Bool ParseCount(const char* text, U32* count) {
+	if (*text == '\0') return FALSE;
+
+	U32 value = 0;
+	for (; *text != '\0'; text++) {
+		if (*text < '0' || *text > '9') return FALSE;
+		U32 digit = (U32)(*text - '0');
+		if (value > (0xFFFFFFFF - digit) / 10) return FALSE;
+		value = value * 10 + digit;
+	}
+	*count = value;
+	return TRUE;
+}
+
+/* Arguments are plain C strings, the String.h functions take bytes */
+static Bool ArgIs(const char* arg, const char* option) {
+	return StringCompare((const U8*)arg, (const U8*)option) == 0;
+}
+
+/* TRUE if arg is prefix followed by at least one more character */
+static Bool ArgHasValue(const char* arg, const char* prefix) {
+	U32 length = GetStringLength(prefix);
+	return GetStringLength(arg) > length && StringCompareLength((const U8*)arg, length, (const U8*)prefix, length) == 0;
+}
+
+static void PrintUsage(void) {
+	Print("usage: della [-j N] [--dump-tokens] [--dump-ast] [--parallel-scan] [--pipeline-scan] [--table-scan] [--cpu-info] [--time-report] [--trace=out.json] [--output=path] <file.della | @response_file>...\n");
+}
 
 int main(int argc, char** argv) {
-	argc = 2;
-	argv[1] = "C:/Users/win10/workspace/Della-O/main.della";
-	if (argc < 2) {
-		LOG_ERROR("Expected file path");
-		return 1;
+	CompilerOptions options = {0};
+	Arena* arena = Arena_Create(ARENA_DEFAULT_BLOCK_SIZE);
+	PathVec inputs;
+	PathVec_InitArena(&inputs, arena);
+	Bool print_cpu_info = FALSE;
+	Bool time_report = FALSE;
+	Bool table_scan = FALSE;
+	const char* trace_path = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+
+		if (ArgIs(arg, "--dump-tokens")) {
+			options.dump_tokens = TRUE;
+		}
+		else if (ArgIs(arg, "--dump-ast")) {
+			options.dump_ast = TRUE;
+		}
+		else if (ArgIs(arg, "--parallel-scan")) {
+			options.parallel_scan = TRUE;
+		}
+		else if (ArgIs(arg, "--pipeline-scan")) {
+			options.pipeline_scan = TRUE;
+		}
+		else if (ArgIs(arg, "--table-scan")) {
+			table_scan = TRUE;
+		}
+		else if (ArgIs(arg, "--cpu-info")) {
+			print_cpu_info = TRUE;
+		}
+		else if (ArgHasValue(arg, "--output=")) {
+			options.output_path = arg + 9;
+		}
+		else if (ArgIs(arg, "--time-report")) {
+			time_report = TRUE;
+		}
+		else if (ArgHasValue(arg, "--trace=")) {
+			trace_path = arg + 8;
+		}
+		else if (ArgIs(arg, "-j") && i + 1 < argc) {
+			if (!ParseCount(argv[++i], &options.thread_count)) {
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (arg[0] == '-' && arg[1] == 'j') {
+			if (!ParseCount(arg + 2, &options.thread_count)) {
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (arg[0] == '@') {
+			if (!ReadResponseFile(&inputs, arg + 1, arena)) {
+				LOG_ERROR("Couldn't read response file\n");
+				return 1;
+			}
+		}
+		else if (arg[0] == '-') {
+			PrintUsage();
+			return 1;
+		}
+		else {
+			PathVec_Push(&inputs, arg);
+		}
+	}
+
+	/* the kernel tables are plain globals, they have to be filled in before any other thread starts */
+	CPUInfo cpu_info = {0};
+	DetectArch(&cpu_info);
+	ScannerKernelsInit(&cpu_info);
+	KeywordCheckList();
+	StringKernelsInit(&cpu_info);
+	if (table_scan) Scanner_SetMode(SCANNER_MODE_TABLE);
+
+	/* argument errors above are logged synchronously, everything from here goes through the writer thread */
+	Logger_Init();
+	Profile_Init(time_report || trace_path != NULL);
+	Profile_SetThreadName("main", PROFILE_NO_INDEX);
+
+	if (print_cpu_info) {
+		DebugCPUInfo(cpu_info);
+		Print("Scanner kernels: %s\n", g_scannerKernels.name);
+		Print("String kernels: %s\n", g_stringKernels.name);
 	}
 
-	if (argc > 3) {
-		LOG_ERROR("More than 1 file is not currently supported");
-		return 1;
+	U32 failed = 0;
+	if (inputs.count != 0) {
+		options.input_paths = inputs.data;
+		options.input_count = inputs.count;
+		failed = CompilerMain(&options, &cpu_info);
+	}
+	else if (!print_cpu_info) {
+		LOG_ERROR("Expected file path\n");
+		PrintUsage();
+		failed = 1;
 	}
 
-	char* file_path = argv[1];
-	CompilerMain(file_path);
+	if (time_report) {
+		Profile_PrintReport();
+	}
+	if (trace_path != NULL && !Profile_WriteTrace(trace_path)) {
+		LOG_ERROR("Couldn't write trace file\n");
+	}
+	/* events point at the input paths, so they go before the arena */
+	Profile_Shutdown();
 
+	DeallocateCPUInfo(&cpu_info);
+	Arena_Destroy(arena);
+	Logger_Shutdown();
 
-	return 0;
-}
\ No newline at end of file
+	return failed != 0;
+}
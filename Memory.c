@@ -1,13 +1,134 @@
 #include "Memory.h"
 
 #include "Memory_Win32.h"
+#include "Memory_Linux.h"
+#include "StringKernels.h"
 
 #include "stdlib.h"
 
+#ifdef MEMORY_STATS
+#include "Atomic.h"
+#include "Thread.h"
+#include "String.h"
+#include "Logger.h"
+
+#define MEMORY_MAX_TAGS     64
+#define MEMORY_SIZE_CLASSES 40              // class n holds sizes in (2^(n-1), 2^n]
+#define MEMORY_HEADER_SIZE  16              // keeps the user pointer 16-byte aligned
+#define MEMORY_HEADER_MAGIC 0x4D454D53u
+
+typedef struct memoryheader_t {
+	Size_t size;
+	U32 tag;
+	U32 magic;
+} MemoryHeader;
+
+typedef struct memorytag_t {
+	const char* name;
+	U64 allocations;
+	U64 bytes_requested;
+	U64 live_bytes;
+	U64 peak_bytes;
+} MemoryTag;
+
+static MemoryStats g_memoryStats;
+static MemoryTag g_memoryTags[MEMORY_MAX_TAGS] = { { "untagged", 0, 0, 0, 0 } };
+static U32 g_memoryTagCount = 1;
+static U32 g_memoryTagLock;
+static U64 g_memorySizeClasses[MEMORY_SIZE_CLASSES];
+static U32 g_memoryReportRegistered;
+
+static THREAD_LOCAL U32 g_memoryCurrentTag;
+static THREAD_LOCAL const char* g_memoryCurrentSite;
+
+static U32 MemorySizeClass(Size_t size) {
+	U32 size_class = 0;
+	while (size_class + 1 < MEMORY_SIZE_CLASSES && ((Size_t)1 << size_class) < size) size_class++;
+	return size_class;
+}
+
+static void MemoryReportAtExit(void) {
+	Memory_Report();
+}
+
+static void MemoryAccountAlloc(MemoryHeader* header, Size_t size) {
+	header->size = size;
+	header->tag = g_memoryCurrentTag;
+	header->magic = MEMORY_HEADER_MAGIC;
+
+	MemoryTag* tag = &g_memoryTags[header->tag];
+	Atomic_AddRelaxedU64(&tag->allocations, 1);
+	Atomic_AddRelaxedU64(&tag->bytes_requested, size);
+	Atomic_MaxU64(&tag->peak_bytes, Atomic_AddRelaxedU64(&tag->live_bytes, size));
+
+	Atomic_AddRelaxedU64(&g_memoryStats.bytes_requested, size);
+	Atomic_MaxU64(&g_memoryStats.peak_bytes, Atomic_AddRelaxedU64(&g_memoryStats.live_bytes, size));
+	Atomic_AddRelaxedU64(&g_memorySizeClasses[MemorySizeClass(size)], 1);
+}
+
+static void MemoryAccountFree(MemoryHeader* header) {
+	if (header->magic != MEMORY_HEADER_MAGIC) {
+		LOG_ERROR("Free of a block that wasn't allocated by Malloc\n");
+		return;
+	}
+	Atomic_AddRelaxedU64(&g_memoryTags[header->tag].live_bytes, (U64)0 - header->size);
+	Atomic_AddRelaxedU64(&g_memoryStats.live_bytes, (U64)0 - header->size);
+}
+
+void Memory_SetTag(const char* site) {
+	if (site == g_memoryCurrentSite) return;
+	if (site == NULL) {
+		g_memoryCurrentTag = 0;
+		g_memoryCurrentSite = NULL;
+		return;
+	}
+
+	/* registration is rare (once per site), a spin lock is plenty */
+	while (!Atomic_CompareExchangeU32(&g_memoryTagLock, 0, 1)) Atomic_Pause();
+
+	U32 tag = 0;
+	for (U32 i = 1; i < g_memoryTagCount; i++) {
+		if (g_memoryTags[i].name == site || StringCompare((const U8*)g_memoryTags[i].name, (const U8*)site) == 0) {
+			tag = i;
+			break;
+		}
+	}
+	if (tag == 0 && g_memoryTagCount < MEMORY_MAX_TAGS) {
+		tag = g_memoryTagCount++;
+		g_memoryTags[tag].name = site;
+	}
+
+	Atomic_StoreU32(&g_memoryTagLock, 0);
+
+	g_memoryCurrentTag = tag;
+	g_memoryCurrentSite = site;
+}
+
+const char* Memory_GetTag(void) {
+	return g_memoryCurrentSite;
+}
+#endif
+
 void* Malloc(Size_t size) {
 	void* data = NULL;
+#ifdef MEMORY_STATS
+	if (Atomic_CompareExchangeU32(&g_memoryReportRegistered, 0, 1)) atexit(MemoryReportAtExit);
+	Atomic_AddRelaxedU64(&g_memoryStats.allocations, 1);
+	Size_t real_size = size + MEMORY_HEADER_SIZE;
+#else
+	Size_t real_size = size;
+#endif
+
 #ifdef _WIN32
-	data = Win32_Malloc(size);
+	data = Win32_Malloc(real_size);
+#elif defined(__linux__)
+	data = Linux_Malloc(real_size);
+#endif
+
+#ifdef MEMORY_STATS
+	if (data == NULL) return NULL;
+	MemoryAccountAlloc(data, size);
+	data = (U8*)data + MEMORY_HEADER_SIZE;
 #endif
 	return data;
 }
@@ -16,23 +137,223 @@ void* Realloc(void* data, Size_t size) {
 	if (data == NULL) return NULL;
 	void* tmpData = NULL;
 
+#ifdef MEMORY_STATS
+	Atomic_AddRelaxedU64(&g_memoryStats.reallocations, 1);
+	MemoryHeader* header = (MemoryHeader*)((U8*)data - MEMORY_HEADER_SIZE);
+	MemoryHeader old_header = *header;
+	data = header;
+	Size_t real_size = size + MEMORY_HEADER_SIZE;
+#else
+	Size_t real_size = size;
+#endif
+
 #ifdef _WIN32
-	tmpData = Win32_Realloc(data, size);
+	tmpData = Win32_Realloc(data, real_size);
+#elif defined(__linux__)
+	tmpData = Linux_Realloc(data, real_size);
 #endif
 
+#ifdef MEMORY_STATS
+	if (tmpData == NULL) return NULL;
+	/* the grown block moves to the current tag, that's the phase that wanted it */
+	MemoryAccountFree(&old_header);
+	MemoryAccountAlloc(tmpData, size);
+	tmpData = (U8*)tmpData + MEMORY_HEADER_SIZE;
+#endif
 	return tmpData;
 }
 
 void Free(void* ptr) {
+#ifdef MEMORY_STATS
+	if (ptr == NULL) return;
+	Atomic_AddRelaxedU64(&g_memoryStats.frees, 1);
+	ptr = (U8*)ptr - MEMORY_HEADER_SIZE;
+	MemoryAccountFree(ptr);
+#endif
+
 #ifdef _WIN32
 	Win32_Free(ptr);
+#elif defined(__linux__)
+	Linux_Free(ptr);
+#endif
+}
+
+void Memcpy(void* dest, const void* src, Size_t size) {
+	if (dest == NULL) return;
+	/* the kernels handle small copies inline and hand big ones to the platform */
+	g_stringKernels.copy(dest, src, size);
+}
+
+void Memmove(void* dest, const void* src, Size_t size) {
+	if (dest == NULL) return;
+
+#ifdef _WIN32
+	Win32_Memmove(dest, src, size);
+#elif defined(__linux__)
+	Linux_Memmove(dest, src, size);
+#endif
+}
+
+Bool Memory_GetStats(MemoryStats* stats) {
+#ifdef MEMORY_STATS
+	stats->allocations = Atomic_LoadU64(&g_memoryStats.allocations);
+	stats->reallocations = Atomic_LoadU64(&g_memoryStats.reallocations);
+	stats->frees = Atomic_LoadU64(&g_memoryStats.frees);
+	stats->bytes_requested = Atomic_LoadU64(&g_memoryStats.bytes_requested);
+	stats->live_bytes = Atomic_LoadU64(&g_memoryStats.live_bytes);
+	stats->peak_bytes = Atomic_LoadU64(&g_memoryStats.peak_bytes);
+	return TRUE;
+#else
+	stats->allocations = 0;
+	stats->reallocations = 0;
+	stats->frees = 0;
+	stats->bytes_requested = 0;
+	stats->live_bytes = 0;
+	stats->peak_bytes = 0;
+	return FALSE;
 #endif
 }
 
-void Memcpy(void* dest, const void* src, int size) {
-	if (dest == NULL) return NULL;
+void Memory_Report(void) {
+#ifdef MEMORY_STATS
+	MemoryStats stats;
+	Memory_GetStats(&stats);
+
+	Print("\n==== memory report ====\n");
+	Print("allocations: %llu  reallocations: %llu  frees: %llu\n",
+		(unsigned long long)stats.allocations, (unsigned long long)stats.reallocations, (unsigned long long)stats.frees);
+	Print("bytes requested: %llu  live: %llu  peak live: %llu  peak rss: %llu\n",
+		(unsigned long long)stats.bytes_requested, (unsigned long long)stats.live_bytes,
+		(unsigned long long)stats.peak_bytes, (unsigned long long)Memory_GetPeakRSS());
+
+	Print("\n%-24s %12s %16s %14s %14s\n", "tag", "allocations", "bytes", "live", "peak live");
+	for (U32 i = 0; i < g_memoryTagCount; i++) {
+		MemoryTag* tag = &g_memoryTags[i];
+		if (tag->allocations == 0) continue;
+		Print("%-24s %12llu %16llu %14llu %14llu\n", tag->name,
+			(unsigned long long)tag->allocations, (unsigned long long)tag->bytes_requested,
+			(unsigned long long)tag->live_bytes, (unsigned long long)tag->peak_bytes);
+	}
+
+	Print("\n%-24s %12s\n", "size class", "count");
+	for (U32 i = 0; i < MEMORY_SIZE_CLASSES; i++) {
+		U64 count = Atomic_LoadU64(&g_memorySizeClasses[i]);
+		if (count == 0) continue;
+		if (i + 1 == MEMORY_SIZE_CLASSES) Print("> %-22llu %12llu\n", 1ull << (i - 1), (unsigned long long)count);
+		else Print("<= %-21llu %12llu\n", 1ull << i, (unsigned long long)count);
+	}
+#endif
+}
 
+Size_t Memory_GetPeakRSS(void) {
+	Size_t peak = 0;
 #ifdef _WIN32
-	Win32_Memcpy(dest, src, size);
+	peak = Win32_GetPeakRSS();
+#elif defined(__linux__)
+	peak = Linux_GetPeakRSS();
 #endif
-}
\ No newline at end of file
+	return peak;
+}
+
+
+/* The block header is padded so the first allocation in a block starts 16-byte aligned */
+#define ARENA_HEADER_SIZE ((sizeof(ArenaBlock) + 15) & ~(Size_t)15)
+
+static U8* ArenaBlockData(ArenaBlock* block) {
+	return (U8*)block + ARENA_HEADER_SIZE;
+}
+
+static ArenaBlock* ArenaBlockCreate(Arena* arena, Size_t min_capacity) {
+	/* try to recycle a block released by a previous reset first */
+	ArenaBlock** link = &arena->free_blocks;
+	while (*link != NULL) {
+		ArenaBlock* block = *link;
+		if (block->capacity >= min_capacity) {
+			*link = block->prev;
+			block->used = 0;
+			return block;
+		}
+		link = &block->prev;
+	}
+
+	Size_t capacity = arena->block_size > min_capacity ? arena->block_size : min_capacity;
+	ArenaBlock* block = Malloc(ARENA_HEADER_SIZE + capacity);
+	if (block == NULL) return NULL;
+
+	block->prev = NULL;
+	block->capacity = capacity;
+	block->used = 0;
+	return block;
+}
+
+Arena* Arena_Create(Size_t block_size) {
+	Arena* arena = Malloc(sizeof(*arena));
+	if (arena == NULL) return NULL;
+
+	arena->current = NULL;
+	arena->free_blocks = NULL;
+	arena->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK_SIZE;
+	return arena;
+}
+
+void* Arena_Alloc(Arena* arena, Size_t size, Size_t alignment) {
+	ArenaBlock* block = arena->current;
+
+	if (block != NULL) {
+		Size_t base = (Size_t)ArenaBlockData(block);
+		Size_t offset = ((base + block->used + alignment - 1) & ~(alignment - 1)) - base;
+		if (offset + size <= block->capacity) {
+			block->used = offset + size;
+			return (U8*)base + offset;
+		}
+	}
+
+	/* block data is 16-byte aligned, anything stricter needs slack */
+	Size_t slack = alignment > 16 ? alignment : 0;
+	ArenaBlock* new_block = ArenaBlockCreate(arena, size + slack);
+	if (new_block == NULL) return NULL;
+
+	new_block->prev = block;
+	arena->current = new_block;
+
+	Size_t base = (Size_t)ArenaBlockData(new_block);
+	Size_t offset = ((base + alignment - 1) & ~(alignment - 1)) - base;
+	new_block->used = offset + size;
+	return (U8*)base + offset;
+}
+
+ArenaMark Arena_Mark(Arena* arena) {
+	ArenaMark mark;
+	mark.block = arena->current;
+	mark.used = arena->current ? arena->current->used : 0;
+	return mark;
+}
+
+void Arena_Reset(Arena* arena, ArenaMark mark) {
+	while (arena->current != mark.block) {
+		ArenaBlock* block = arena->current;
+		arena->current = block->prev;
+
+		block->prev = arena->free_blocks;
+		arena->free_blocks = block;
+	}
+
+	if (arena->current != NULL) {
+		arena->current->used = mark.used;
+	}
+}
+
+static void ArenaFreeChain(ArenaBlock* block) {
+	while (block != NULL) {
+		ArenaBlock* prev = block->prev;
+		Free(block);
+		block = prev;
+	}
+}
+
+void Arena_Destroy(Arena* arena) {
+	if (arena == NULL) return;
+	ArenaFreeChain(arena->current);
+	ArenaFreeChain(arena->free_blocks);
+	Free(arena);
+}
@@ -7,4 +7,78 @@ void* Realloc(void* data, Size_t size);
 
 
 void Memcpy(void* dest, const void* src, Size_t size);
-void Memmove(void* dest, const void* src, Size_t size);
\ No newline at end of file
+void Memmove(void* dest, const void* src, Size_t size);
+
+
+/*
+	Allocation instrumentation, compiled in with MEMORY_STATS.
+	Every block then carries a small header with its size and tag so Free can
+	account for live bytes. A report is printed when the process exits.
+*/
+typedef struct memorystats_t {
+	U64 allocations;
+	U64 reallocations;
+	U64 frees;
+	U64 bytes_requested;
+	U64 live_bytes;
+	U64 peak_bytes;
+} MemoryStats;
+
+/* Returns FALSE (and zeroed stats) when MEMORY_STATS is off */
+Bool Memory_GetStats(MemoryStats* stats);
+
+/* Prints the counters, the per-tag table and the size-class histogram, no-op when MEMORY_STATS is off */
+void Memory_Report(void);
+
+/*
+	MALLOC_TAG(site) attributes every following allocation made by the calling
+	thread to site (a string literal), until the next MALLOC_TAG.
+	MALLOC_TAG_CURRENT() is the calling thread's site (NULL when untagged), code
+	running on a thread it doesn't own puts it back with MALLOC_TAG when done.
+*/
+#ifdef MEMORY_STATS
+void Memory_SetTag(const char* site);
+const char* Memory_GetTag(void);
+#define MALLOC_TAG(site) Memory_SetTag(site)
+#define MALLOC_TAG_CURRENT() Memory_GetTag()
+#else
+#define MALLOC_TAG(site) ((void)(site))
+#define MALLOC_TAG_CURRENT() NULL
+#endif
+
+/* Peak resident set size of the process in bytes, 0 if the platform can't tell */
+Size_t Memory_GetPeakRSS(void);
+
+/*
+	Arena (bump) allocator for compiler-lifetime allocations.
+	Memory is handed out from large blocks and is only released all at once,
+	either by rewinding to a mark or by destroying the arena.
+*/
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+#define ARENA_DEFAULT_ALIGNMENT  (sizeof(void*))
+
+typedef struct arena_block_t {
+	struct arena_block_t* prev;
+	Size_t capacity;
+	Size_t used;
+} ArenaBlock;
+
+typedef struct arena_t {
+	ArenaBlock* current;
+	ArenaBlock* free_blocks;    // blocks released by Arena_Reset, kept for reuse
+	Size_t block_size;
+} Arena;
+
+typedef struct arena_mark_t {
+	ArenaBlock* block;
+	Size_t used;
+} ArenaMark;
+
+Arena* Arena_Create(Size_t block_size);
+void*  Arena_Alloc(Arena* arena, Size_t size, Size_t alignment);
+ArenaMark Arena_Mark(Arena* arena);
+void   Arena_Reset(Arena* arena, ArenaMark mark);
+void   Arena_Destroy(Arena* arena);
+
+#define ARENA_PUSH(arena, type)         ((type*)Arena_Alloc((arena), sizeof(type), _Alignof(type)))
+#define ARENA_PUSH_ARRAY(arena, type, n) ((type*)Arena_Alloc((arena), sizeof(type) * (n), _Alignof(type)))
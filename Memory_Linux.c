@@ -0,0 +1,39 @@
+#ifdef __linux__
+#include "Memory_Linux.h"
+#include "Logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+void* Linux_Malloc(Size_t size) {
+	return malloc(size);
+}
+
+void* Linux_Realloc(void* block, Size_t size) {
+	void* new_block = realloc(block, size);
+	if (!new_block) {
+		LOG_ERROR("realloc failed\n");
+		return NULL;
+	}
+	return new_block;
+}
+
+void  Linux_Free(void* block) {
+	free(block);
+}
+
+void Linux_Memcpy(void* dest, const void* src, Size_t length) {
+	memcpy(dest, src, length);
+}
+
+void Linux_Memmove(void* dest, const void* src, Size_t length) {
+	memmove(dest, src, length);
+}
+
+Size_t Linux_GetPeakRSS(void) {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+	return (Size_t)usage.ru_maxrss * 1024;   // reported in KiB
+}
+#endif
@@ -0,0 +1,12 @@
+#pragma once
+#include "Common.h"
+
+void* Linux_Malloc(Size_t size);
+void  Linux_Free(void* block);
+void* Linux_Realloc(void* block, Size_t size);
+
+
+void Linux_Memcpy(void* dest, const void* src, Size_t length);
+void Linux_Memmove(void* dest, const void* src, Size_t length);
+
+Size_t Linux_GetPeakRSS(void);
@@ -2,6 +2,7 @@
 #include "Logger.h"
 
 #include <windows.h>
+#include <psapi.h>
 
 HANDLE g_processHeap = NULL;
 
@@ -20,6 +21,7 @@ void* Win32_Realloc(void* block, Size_t size) {
 		LOG_ERROR("HeapReAlloc failed with error code %lu\n", err);
 		return NULL;
 	}
+	return new_block;
 }
 
 void  Win32_Free(void* block){
@@ -32,4 +34,10 @@ void Win32_Memcpy(void* dest, const void* src, Size_t length){
 
 void Win32_Memmove(void* dest, const void* src, Size_t length){
 	RtlMoveMemory(dest, src, length);
+}
+
+Size_t Win32_GetPeakRSS(void) {
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return counters.PeakWorkingSetSize;
 }
\ No newline at end of file
@@ -7,4 +7,6 @@ void* Win32_Realloc(void* block, Size_t size);
 
 
 void Win32_Memcpy(void* dest, const void* src, Size_t length);
-void Win32_Memmove(void* dest, const void* src, Size_t length);
\ No newline at end of file
+void Win32_Memmove(void* dest, const void* src, Size_t length);
+
+Size_t Win32_GetPeakRSS(void);
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "Output.h"
+#include "Output_Win32.h"
+#include "Output_Linux.h"
+#include "Memory.h"
+#include "String.h"
+#include "Logger.h"
+
+#include <stdio.h>
+
+#define OUTPUT_MAX_CAPACITY 0xFFFFFFFFu     // sizes are U32, a memory sink can't grow past this
+
+static const char g_digitPairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static Bool OutputWriteV(OutputHandle handle, const U8* const* buffers, const U32* lengths, U32 count) {
+	Bool written = FALSE;
+#ifdef _WIN32
+	written = Win32_OutputWriteV(handle, buffers, lengths, count);
+#elif defined(__linux__)
+	written = Linux_OutputWriteV(handle, buffers, lengths, count);
+#endif
+	return written;
+}
+
+static void OutputAllocate(Output* out, U32 capacity) {
+	out->data = Malloc(capacity);
+	if (out->data == NULL) {
+		PANIC("Couldn't allocate output buffer");
+	}
+	out->capacity = capacity;
+}
+
+void Output_InitMemory(Output* out) {
+	out->data = NULL;
+	out->size = 0;
+	out->capacity = 0;
+	out->kind = OUTPUT_MEMORY;
+	out->handle = 0;
+	out->owns_handle = FALSE;
+	out->failed = FALSE;
+}
+
+void Output_InitHandle(Output* out, OutputHandle handle) {
+	Output_InitMemory(out);
+	out->kind = OUTPUT_HANDLE;
+	out->handle = handle;
+	OutputAllocate(out, OUTPUT_BUFFER_SIZE);
+}
+
+void Output_InitStandard(Output* out, OutputStandard standard) {
+	OutputHandle handle = 0;
+#ifdef _WIN32
+	handle = Win32_OutputStandard(standard);
+#elif defined(__linux__)
+	handle = Linux_OutputStandard(standard);
+#endif
+	Output_InitHandle(out, handle);
+}
+
+Bool Output_OpenFile(Output* out, const char* path) {
+	OutputHandle handle = 0;
+	Bool opened = FALSE;
+#ifdef _WIN32
+	opened = Win32_OutputOpen((const U8*)path, &handle);
+#elif defined(__linux__)
+	opened = Linux_OutputOpen((const U8*)path, &handle);
+#endif
+	if (!opened) return FALSE;
+
+	Output_InitHandle(out, handle);
+	out->owns_handle = TRUE;
+	return TRUE;
+}
+
+void Output_Flush(Output* out) {
+	if (out->size == 0) return;
+
+	if (out->kind == OUTPUT_HANDLE && !out->failed) {
+		const U8* buffers[1] = {out->data};
+		U32 lengths[1] = {out->size};
+		out->failed = !OutputWriteV(out->handle, buffers, lengths, 1);
+	}
+	out->size = 0;
+}
+
+/* Makes room for length more bytes, FALSE means they should bypass the buffer */
+static Bool OutputReserve(Output* out, U32 length) {
+	Size_t required = (Size_t)out->size + length;
+	if (required <= out->capacity) return TRUE;
+
+	if (out->kind == OUTPUT_HANDLE) {
+		Output_Flush(out);
+		return length <= out->capacity;
+	}
+
+	if (required > OUTPUT_MAX_CAPACITY) {
+		PANIC("Output buffer would exceed %u bytes", OUTPUT_MAX_CAPACITY);
+	}
+	Size_t capacity = out->capacity ? out->capacity : 256;
+	while (capacity < required) capacity *= 2;
+	if (capacity > OUTPUT_MAX_CAPACITY) capacity = OUTPUT_MAX_CAPACITY;
+
+	out->data = out->data ? Realloc(out->data, capacity) : Malloc(capacity);
+	if (out->data == NULL) {
+		PANIC("Couldn't grow output buffer");
+	}
+	out->capacity = (U32)capacity;
+	return TRUE;
+}
+
+void Output_WriteBytes(Output* out, const U8* bytes, U32 length) {
+	if (length == 0) return;
+
+	if (!OutputReserve(out, length)) {
+		/* bigger than the whole buffer, the buffer was just flushed so order is kept */
+		if (!out->failed) out->failed = !OutputWriteV(out->handle, &bytes, &length, 1);
+		return;
+	}
+	Memcpy(out->data + out->size, bytes, length);
+	out->size += length;
+}
+
+void Output_WriteString(Output* out, const char* text) {
+	Output_WriteBytes(out, (const U8*)text, GetStringLength(text));
+}
+
+void Output_WriteStrView(Output* out, StrView text) {
+	Output_WriteBytes(out, text.ptr, text.len);
+}
+
+void Output_WriteChar(Output* out, U8 c) {
+	if (out->size < out->capacity) {
+		out->data[out->size++] = c;
+		return;
+	}
+	Output_WriteBytes(out, &c, 1);
+}
+
+void Output_WriteU64(Output* out, U64 value) {
+	/* two digits per step, written backwards into a scratch buffer */
+	U8 digits[20];
+	U32 position = sizeof(digits);
+	while (value >= 100) {
+		U32 pair = (U32)(value % 100) * 2;
+		value /= 100;
+		digits[--position] = (U8)g_digitPairs[pair + 1];
+		digits[--position] = (U8)g_digitPairs[pair];
+	}
+	if (value >= 10) {
+		U32 pair = (U32)value * 2;
+		digits[--position] = (U8)g_digitPairs[pair + 1];
+		digits[--position] = (U8)g_digitPairs[pair];
+	}
+	else {
+		digits[--position] = (U8)('0' + value);
+	}
+	Output_WriteBytes(out, digits + position, sizeof(digits) - position);
+}
+
+void Output_WriteU32(Output* out, U32 value) {
+	Output_WriteU64(out, value);
+}
+
+void Output_WriteS64(Output* out, S64 value) {
+	if (value < 0) {
+		Output_WriteChar(out, '-');
+		Output_WriteU64(out, (U64)0 - (U64)value);
+		return;
+	}
+	Output_WriteU64(out, (U64)value);
+}
+
+void Output_FormatV(Output* out, const char* fmt, va_list args) {
+	va_list measure_args;
+	va_copy(measure_args, args);
+	int length = vsnprintf(NULL, 0, fmt, measure_args);
+	va_end(measure_args);
+	if (length <= 0) return;
+
+	/* vsnprintf always writes a terminator, reserve room for it and don't count it */
+	if (OutputReserve(out, (U32)length + 1)) {
+		vsnprintf((char*)out->data + out->size, (Size_t)length + 1, fmt, args);
+		out->size += (U32)length;
+		return;
+	}
+
+	U8* text = Malloc((Size_t)length + 1);
+	if (text == NULL) {
+		PANIC("Couldn't allocate formatted output");
+	}
+	vsnprintf((char*)text, (Size_t)length + 1, fmt, args);
+	Output_WriteBytes(out, text, (U32)length);
+	Free(text);
+}
+
+void Output_Format(Output* out, const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	Output_FormatV(out, fmt, args);
+	va_end(args);
+}
+
+void Output_WriteOutput(Output* out, const Output* source) {
+	if (source->size == 0) return;
+
+	if (out->kind == OUTPUT_HANDLE && (Size_t)out->size + source->size > out->capacity) {
+		/* pending bytes and the whole source leave in one system call */
+		if (!out->failed) {
+			const U8* buffers[2] = {out->data, source->data};
+			U32 lengths[2] = {out->size, source->size};
+			out->failed = !OutputWriteV(out->handle, buffers, lengths, 2);
+		}
+		out->size = 0;
+		return;
+	}
+	Output_WriteBytes(out, source->data, source->size);
+}
+
+Bool Output_Close(Output* out) {
+	Output_Flush(out);
+	if (out->owns_handle) {
+#ifdef _WIN32
+		Win32_OutputClose(out->handle);
+#elif defined(__linux__)
+		Linux_OutputClose(out->handle);
+#endif
+	}
+
+	Bool succeeded = !out->failed;
+	Free(out->data);
+	Output_InitMemory(out);
+	return succeeded;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "Common.h"
+#include "String.h"
+
+/*
+	Buffered output sink for dumps, diagnostics and anything else the compiler emits.
+	A handle sink collects bytes in a large buffer and hands them to the OS in
+	one write when it fills up or is flushed. A memory sink only grows, it is
+	for output that is assembled first and emitted later (per-file results).
+	The Write functions skip printf parsing, Output_Format is there for the rest.
+*/
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+/* fd on Linux, HANDLE on Windows */
+typedef Size_t OutputHandle;
+
+typedef enum {
+	OUTPUT_STDOUT,
+	OUTPUT_STDERR,
+} OutputStandard;
+
+typedef enum {
+	OUTPUT_MEMORY,
+	OUTPUT_HANDLE,
+} OutputKind;
+
+typedef struct output_t {
+	U8* data;
+	U32 size;
+	U32 capacity;
+	OutputKind kind;
+	OutputHandle handle;
+	Bool owns_handle;       // opened by Output_OpenFile, closed by Output_Close
+	Bool failed;            // a write to the handle failed, later output is dropped
+} Output;
+
+void Output_InitMemory(Output* out);
+void Output_InitStandard(Output* out, OutputStandard standard);
+void Output_InitHandle(Output* out, OutputHandle handle);
+Bool Output_OpenFile(Output* out, const char* path);
+
+void Output_WriteBytes(Output* out, const U8* bytes, U32 length);
+void Output_WriteString(Output* out, const char* text);
+void Output_WriteStrView(Output* out, StrView text);
+void Output_WriteChar(Output* out, U8 c);
+void Output_WriteU32(Output* out, U32 value);
+void Output_WriteU64(Output* out, U64 value);
+void Output_WriteS64(Output* out, S64 value);
+void Output_Format(Output* out, const char* fmt, ...);
+void Output_FormatV(Output* out, const char* fmt, va_list args);
+
+/* Appends everything in a memory sink, a handle sink gets both buffers in a single writev */
+void Output_WriteOutput(Output* out, const Output* source);
+
+/* Empties a memory sink, writes out a handle sink */
+void Output_Flush(Output* out);
+
+/* Flushes, closes an owned handle and releases the buffer. FALSE if any write failed */
+Bool Output_Close(Output* out);
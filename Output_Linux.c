@@ -0,0 +1,64 @@
+#ifdef __linux__
+#include "Output_Linux.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#define LINUX_OUTPUT_MAX_IOV 8
+
+OutputHandle Linux_OutputStandard(OutputStandard standard) {
+	return standard == OUTPUT_STDOUT ? STDOUT_FILENO : STDERR_FILENO;
+}
+
+Bool Linux_OutputOpen(const U8* path, OutputHandle* handle) {
+	int fd = open((const char*)path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) return FALSE;
+	*handle = (OutputHandle)fd;
+	return TRUE;
+}
+
+void Linux_OutputClose(OutputHandle handle) {
+	close((int)handle);
+}
+
+/* Writes one batch of at most LINUX_OUTPUT_MAX_IOV buffers */
+static Bool LinuxWriteBatch(int fd, struct iovec* current, int iov_count) {
+	while (iov_count > 0) {
+		ssize_t written = writev(fd, current, iov_count);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return FALSE;
+		}
+
+		/* drop what went out and resume in the middle of a partially written buffer */
+		while (iov_count > 0 && (Size_t)written >= current->iov_len) {
+			written -= (ssize_t)current->iov_len;
+			current++;
+			iov_count--;
+		}
+		if (iov_count > 0) {
+			current->iov_base = (U8*)current->iov_base + written;
+			current->iov_len -= (Size_t)written;
+		}
+	}
+	return TRUE;
+}
+
+Bool Linux_OutputWriteV(OutputHandle handle, const U8* const* buffers, const U32* lengths, U32 count) {
+	struct iovec iov[LINUX_OUTPUT_MAX_IOV];
+	U32 next = 0;
+	while (next < count) {
+		int iov_count = 0;
+		for (; next < count && iov_count < LINUX_OUTPUT_MAX_IOV; next++) {
+			if (lengths[next] == 0) continue;
+			iov[iov_count].iov_base = (void*)buffers[next];
+			iov[iov_count].iov_len = lengths[next];
+			iov_count++;
+		}
+		if (!LinuxWriteBatch((int)handle, iov, iov_count)) return FALSE;
+	}
+	return TRUE;
+}
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+#include "Output.h"
+
+OutputHandle Linux_OutputStandard(OutputStandard standard);
+Bool Linux_OutputOpen(const U8* path, OutputHandle* handle);
+void Linux_OutputClose(OutputHandle handle);
+
+/* Writes every buffer in order, retrying short writes */
+Bool Linux_OutputWriteV(OutputHandle handle, const U8* const* buffers, const U32* lengths, U32 count);
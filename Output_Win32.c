@@ -0,0 +1,33 @@
+#include "Output_Win32.h"
+
+#include <windows.h>
+
+OutputHandle Win32_OutputStandard(OutputStandard standard) {
+	return (OutputHandle)GetStdHandle(standard == OUTPUT_STDOUT ? STD_OUTPUT_HANDLE : STD_ERROR_HANDLE);
+}
+
+Bool Win32_OutputOpen(const U8* path, OutputHandle* handle) {
+	HANDLE file = CreateFileA((LPCSTR)path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return FALSE;
+	*handle = (OutputHandle)file;
+	return TRUE;
+}
+
+void Win32_OutputClose(OutputHandle handle) {
+	CloseHandle((HANDLE)handle);
+}
+
+/* WriteFileGather needs unbuffered, page-aligned I/O, so buffers go out one WriteFile each */
+Bool Win32_OutputWriteV(OutputHandle handle, const U8* const* buffers, const U32* lengths, U32 count) {
+	for (U32 i = 0; i < count; i++) {
+		U32 offset = 0;
+		while (offset < lengths[i]) {
+			DWORD written = 0;
+			if (!WriteFile((HANDLE)handle, buffers[i] + offset, lengths[i] - offset, &written, NULL)) {
+				return FALSE;
+			}
+			offset += written;
+		}
+	}
+	return TRUE;
+}
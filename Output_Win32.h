@@ -0,0 +1,8 @@
+#pragma once
+#include "Output.h"
+
+OutputHandle Win32_OutputStandard(OutputStandard standard);
+Bool Win32_OutputOpen(const U8* path, OutputHandle* handle);
+void Win32_OutputClose(OutputHandle handle);
+
+Bool Win32_OutputWriteV(OutputHandle handle, const U8* const* buffers, const U32* lengths, U32 count);
@@ -0,0 +1,468 @@
+#include "Parser.h"
+#include "Logger.h"
+
+typedef enum {
+	PRECEDENCE_NONE,
+	PRECEDENCE_ASSIGN,      // = (right associative)
+	PRECEDENCE_EQUALITY,    // == !=
+	PRECEDENCE_COMPARE,     // < > <= >=
+	PRECEDENCE_ADD,         // + -
+	PRECEDENCE_MUL,         // * /
+	PRECEDENCE_PREFIX,      // -x
+	PRECEDENCE_CALL,        // f(x)
+} Precedence;
+
+/* Binding power of every token that can follow an operand, PRECEDENCE_NONE ends the expression */
+static const U8 InfixPrecedenceTable[TOKEN_COUNT] = {
+	[TOKEN_EQUAL] = PRECEDENCE_ASSIGN,
+	[TOKEN_EQUAL_EQUAL] = PRECEDENCE_EQUALITY,
+	[TOKEN_BANG_EQUAL] = PRECEDENCE_EQUALITY,
+	[TOKEN_LESS_THAN] = PRECEDENCE_COMPARE,
+	[TOKEN_GREATER_THAN] = PRECEDENCE_COMPARE,
+	[TOKEN_LESS_EQUAL] = PRECEDENCE_COMPARE,
+	[TOKEN_GREATER_EQUAL] = PRECEDENCE_COMPARE,
+	[TOKEN_PLUS] = PRECEDENCE_ADD,
+	[TOKEN_MINUS] = PRECEDENCE_ADD,
+	[TOKEN_MUL] = PRECEDENCE_MUL,
+	[TOKEN_DIV] = PRECEDENCE_MUL,
+	[TOKEN_LEFT_PAREN] = PRECEDENCE_CALL,
+};
+
+typedef struct parser_t {
+	CompilerInfo* info;
+	Ast* ast;
+	TokenBuffer* tokens;
+	ScannerPipe* pipe;          // NULL when tokens already holds the whole stream
+	U32 current;                // next unconsumed token, never an ILLEGAL one
+	U32 depth;
+	U32 error_count;
+	Bool recovering;            // an error was reported, later ones are noise until the next statement
+	Bool gave_up;               // every construct now sees EOF and unwinds
+	AstExtraVec scratch;        // lists under construction, moved to extra once complete
+} ParserInfo;
+
+static U32 ParseStatement(ParserInfo* p);
+static U32 ParseExpression(ParserInfo* p, Precedence min_precedence);
+
+/*
+	Moves current onto the next token that isn't ILLEGAL, pulling from the pipe
+	as needed. The skipped tokens are reported here, so the scanner's errors
+	come out in source order with the parser's.
+*/
+static void ParserSkipIllegal(ParserInfo* p) {
+	for (;;) {
+		if (p->pipe != NULL && p->current == p->tokens->count) {
+			TokenBuffer_Push(p->tokens, ScannerPipe_Next(p->pipe));
+		}
+		if (p->tokens->kind[p->current] != TOKEN_ILLEGAL) return;
+		CompilerReportIllegalToken(p->info, p->current);
+		p->current++;
+	}
+}
+
+static TokenKind ParserPeek(ParserInfo* p) {
+	if (p->gave_up) return TOKEN_EOF;
+	return (TokenKind)p->tokens->kind[p->current];
+}
+
+/* Consumes the current token and returns its index, EOF is never consumed */
+static U32 ParserAdvance(ParserInfo* p) {
+	U32 index = p->current;
+	if (ParserPeek(p) != TOKEN_EOF) {
+		p->current++;
+		ParserSkipIllegal(p);
+	}
+	return index;
+}
+
+static Bool ParserMatch(ParserInfo* p, TokenKind kind) {
+	if (ParserPeek(p) != kind) return FALSE;
+	ParserAdvance(p);
+	return TRUE;
+}
+
+static void ParserGiveUp(ParserInfo* p, U32 token, const char* reason) {
+	CompilerError(p->info, p->tokens->start[token], "%s, skipping the rest of the file", reason);
+	p->gave_up = TRUE;
+}
+
+static void ParserError(ParserInfo* p, U32 token, const char* fmt, ...) {
+	if (p->recovering || p->gave_up) return;
+	p->recovering = TRUE;
+
+	/* right after a skipped ILLEGAL token the scanner's error already covers it */
+	if (token > 0 && p->tokens->kind[token - 1] == TOKEN_ILLEGAL) return;
+
+	va_list args;
+	va_start(args, fmt);
+	CompilerErrorV(p->info, p->tokens->start[token], fmt, args);
+	va_end(args);
+
+	if (++p->error_count == PARSER_MAX_ERRORS) ParserGiveUp(p, token, "too many errors");
+}
+
+static void ParserErrorExpected(ParserInfo* p, const char* expected) {
+	if (ParserPeek(p) == TOKEN_EOF) {
+		ParserError(p, p->current, "expected %s, found the end of the file", expected);
+		return;
+	}
+	StrView text = TokenBuffer_GetText(p->tokens, p->current);
+	ParserError(p, p->current, "expected %s, found '" STRVIEW_FMT "'", expected, STRVIEW_ARG(text));
+}
+
+/*
+	Returns the index of the expected token, or of the offending one (left unconsumed).
+	Reaching the ';' or '}' that closes a statement puts the parser back in sync.
+*/
+static U32 ParserExpect(ParserInfo* p, TokenKind kind, const char* expected) {
+	if (ParserPeek(p) == kind) {
+		if (kind == TOKEN_SEMICOLON || kind == TOKEN_RIGHT_BRACE) p->recovering = FALSE;
+		return ParserAdvance(p);
+	}
+	ParserErrorExpected(p, expected);
+	return p->current;
+}
+
+static U32 ParserErrorNode(ParserInfo* p) {
+	return Ast_AddNode(p->ast, AST_ERROR, p->current, 0, 0);
+}
+
+static Bool ParserEnter(ParserInfo* p) {
+	if (p->depth == PARSER_MAX_DEPTH) {
+		if (!p->gave_up) ParserGiveUp(p, p->current, "nesting is too deep");
+		return FALSE;
+	}
+	p->depth++;
+	return TRUE;
+}
+
+static void ParserLeave(ParserInfo* p) {
+	p->depth--;
+}
+
+/* Copies scratch[mark, count) to the end of extra and pops it, returns where the copy starts */
+static U32 ParserCommitList(ParserInfo* p, U32 mark) {
+	U32 first = p->ast->extra.count;
+	AstExtraVec_Append(&p->ast->extra, p->scratch.data + mark, p->scratch.count - mark);
+	p->scratch.count = mark;
+	return first;
+}
+
+/* Commits the list and stores its bounds in extra, returns the index of the pair */
+static U32 ParserCommitRange(ParserInfo* p, U32 mark) {
+	U32 first = ParserCommitList(p, mark);
+	U32 end = p->ast->extra.count;
+	AstExtraVec_Push(&p->ast->extra, first);
+	AstExtraVec_Push(&p->ast->extra, end);
+	return end;
+}
+
+/* Skips to a statement boundary: past a ';', or up to a token that starts or ends a statement */
+static void ParserSynchronize(ParserInfo* p) {
+	p->recovering = FALSE;
+	for (;;) {
+		switch (ParserPeek(p)) {
+			case TOKEN_SEMICOLON:
+				ParserAdvance(p);
+				return;
+			case TOKEN_FUNC:
+			case TOKEN_IF:
+			case TOKEN_WHILE:
+			case TOKEN_FOR:
+			case TOKEN_LEFT_BRACE:
+			case TOKEN_RIGHT_BRACE:
+			case TOKEN_EOF:
+				return;
+			default:
+				break;
+		}
+		ParserAdvance(p);
+	}
+}
+
+static U32 ParseCall(ParserInfo* p, U32 token, U32 callee) {
+	U32 mark = p->scratch.count;
+	if (ParserPeek(p) != TOKEN_RIGHT_PAREN) {
+		do {
+			U32 argument = ParseExpression(p, PRECEDENCE_ASSIGN);
+			AstExtraVec_Push(&p->scratch, argument);
+		} while (ParserMatch(p, TOKEN_COMMA));
+	}
+	ParserExpect(p, TOKEN_RIGHT_PAREN, "')'");
+
+	U32 arguments = ParserCommitRange(p, mark);
+	return Ast_AddNode(p->ast, AST_CALL, token, callee, arguments);
+}
+
+static U32 ParsePrefix(ParserInfo* p) {
+	switch (ParserPeek(p)) {
+		case TOKEN_IDENTIFIER: {
+			U32 token = ParserAdvance(p);
+			return Ast_AddNode(p->ast, AST_IDENTIFIER, token, p->tokens->value[token], 0);
+		}
+		case TOKEN_NUMERIC: {
+			U32 token = ParserAdvance(p);
+			return Ast_AddNode(p->ast, AST_NUMBER, token, p->tokens->value[token], 0);
+		}
+		case TOKEN_FLOAT: {
+			U32 token = ParserAdvance(p);
+			return Ast_AddNode(p->ast, AST_FLOAT, token, p->tokens->value[token], 0);
+		}
+		case TOKEN_STRING: {
+			U32 token = ParserAdvance(p);
+			return Ast_AddNode(p->ast, AST_STRING, token, 0, 0);
+		}
+		case TOKEN_CHAR: {
+			U32 token = ParserAdvance(p);
+			return Ast_AddNode(p->ast, AST_CHAR, token, p->tokens->value[token], 0);
+		}
+		case TOKEN_MINUS: {
+			U32 token = ParserAdvance(p);
+			U32 operand = ParseExpression(p, PRECEDENCE_PREFIX);
+			return Ast_AddNode(p->ast, AST_NEGATE, token, operand, 0);
+		}
+		case TOKEN_LEFT_PAREN: {
+			/* grouping only steers the shape of the tree, it leaves no node behind */
+			ParserAdvance(p);
+			U32 inner = ParseExpression(p, PRECEDENCE_ASSIGN);
+			ParserExpect(p, TOKEN_RIGHT_PAREN, "')'");
+			return inner;
+		}
+		default:
+			break;
+	}
+
+	ParserErrorExpected(p, "an expression");
+	return ParserErrorNode(p);
+}
+
+/* Parses operators that bind at least as tightly as min_precedence */
+static U32 ParseExpression(ParserInfo* p, Precedence min_precedence) {
+	if (!ParserEnter(p)) return ParserErrorNode(p);
+
+	U32 lhs = ParsePrefix(p);
+	for (;;) {
+		TokenKind kind = ParserPeek(p);
+		Precedence precedence = (Precedence)InfixPrecedenceTable[kind];
+		if (precedence == PRECEDENCE_NONE || precedence < min_precedence) break;
+
+		U32 token = ParserAdvance(p);
+		if (kind == TOKEN_LEFT_PAREN) {
+			lhs = ParseCall(p, token, lhs);
+		}
+		else if (kind == TOKEN_EQUAL) {
+			if (Ast_GetNode(p->ast, lhs)->kind != AST_IDENTIFIER) {
+				ParserError(p, token, "can only assign to a name");
+			}
+			/* same precedence on the right makes a = b = c group as a = (b = c) */
+			U32 rhs = ParseExpression(p, PRECEDENCE_ASSIGN);
+			lhs = Ast_AddNode(p->ast, AST_ASSIGN, token, lhs, rhs);
+		}
+		else {
+			U32 rhs = ParseExpression(p, (Precedence)(precedence + 1));
+			lhs = Ast_AddNode(p->ast, AST_BINARY, token, lhs, rhs);
+			p->ast->nodes.data[lhs].op = (U8)kind;
+		}
+	}
+
+	ParserLeave(p);
+	return lhs;
+}
+
+static U32 ParseBlock(ParserInfo* p) {
+	if (ParserPeek(p) != TOKEN_LEFT_BRACE) {
+		ParserErrorExpected(p, "'{'");
+		return ParserErrorNode(p);
+	}
+	U32 token = ParserAdvance(p);
+	if (!ParserEnter(p)) return ParserErrorNode(p);
+	/* errors inside the block aren't fallout of whatever went wrong before it */
+	p->recovering = FALSE;
+
+	U32 mark = p->scratch.count;
+	while (ParserPeek(p) != TOKEN_RIGHT_BRACE && ParserPeek(p) != TOKEN_EOF) {
+		U32 statement = ParseStatement(p);
+		if (statement != AST_NULL) AstExtraVec_Push(&p->scratch, statement);
+	}
+	ParserExpect(p, TOKEN_RIGHT_BRACE, "'}'");
+	ParserLeave(p);
+
+	U32 first = ParserCommitList(p, mark);
+	return Ast_AddNode(p->ast, AST_BLOCK, token, first, p->ast->extra.count);
+}
+
+/* Types are plain names so far, an error node (the token left unconsumed) if there isn't one */
+static U32 ParseTypeName(ParserInfo* p, const char* expected) {
+	if (ParserPeek(p) != TOKEN_IDENTIFIER) {
+		ParserErrorExpected(p, expected);
+		return ParserErrorNode(p);
+	}
+	U32 token = ParserAdvance(p);
+	return Ast_AddNode(p->ast, AST_IDENTIFIER, token, p->tokens->value[token], 0);
+}
+
+/* func name(a, b: type) -> type { ... } */
+static U32 ParseFunc(ParserInfo* p) {
+	ParserAdvance(p);
+	U32 name = ParserExpect(p, TOKEN_IDENTIFIER, "a function name");
+	ParserExpect(p, TOKEN_LEFT_PAREN, "'('");
+
+	U32 mark = p->scratch.count;
+	if (ParserPeek(p) != TOKEN_RIGHT_PAREN) {
+		do {
+			U32 param = ParserExpect(p, TOKEN_IDENTIFIER, "a parameter name");
+			U32 type = AST_NULL;
+			if (ParserMatch(p, TOKEN_COLON)) {
+				type = ParseTypeName(p, "a type name");
+			}
+			AstExtraVec_Push(&p->scratch, Ast_AddNode(p->ast, AST_PARAM, param, type, 0));
+		} while (ParserMatch(p, TOKEN_COMMA));
+	}
+	ParserExpect(p, TOKEN_RIGHT_PAREN, "')'");
+
+	U32 return_type = AST_NULL;
+	if (ParserMatch(p, TOKEN_ARROW)) {
+		return_type = ParseTypeName(p, "a return type");
+	}
+
+	U32 params = ParserCommitRange(p, mark);
+	AstExtraVec_Push(&p->ast->extra, return_type);
+	U32 body = ParseBlock(p);
+	return Ast_AddNode(p->ast, AST_FUNC, name, params, body);
+}
+
+/* else if chains are built in a loop, each link patches its else slot in the previous one */
+static U32 ParseIf(ParserInfo* p) {
+	U32 first = AST_NULL;
+	U32 previous_branches = 0;
+
+	for (;;) {
+		U32 token = ParserAdvance(p);
+		U32 condition = ParseExpression(p, PRECEDENCE_ASSIGN);
+		U32 then_block = ParseBlock(p);
+
+		U32 branches = p->ast->extra.count;
+		AstExtraVec_Push(&p->ast->extra, then_block);
+		AstExtraVec_Push(&p->ast->extra, AST_NULL);
+		U32 node = Ast_AddNode(p->ast, AST_IF, token, condition, branches);
+
+		if (first == AST_NULL) first = node;
+		else p->ast->extra.data[previous_branches + 1] = node;
+		previous_branches = branches;
+
+		if (!ParserMatch(p, TOKEN_ELSE)) break;
+		if (ParserPeek(p) != TOKEN_IF) {
+			U32 else_block = ParseBlock(p);
+			p->ast->extra.data[branches + 1] = else_block;
+			break;
+		}
+	}
+	return first;
+}
+
+static U32 ParseWhile(ParserInfo* p) {
+	U32 token = ParserAdvance(p);
+	U32 condition = ParseExpression(p, PRECEDENCE_ASSIGN);
+	U32 body = ParseBlock(p);
+	return Ast_AddNode(p->ast, AST_WHILE, token, condition, body);
+}
+
+/* for (init; condition; step) { ... }, each clause may be empty */
+static U32 ParseFor(ParserInfo* p) {
+	U32 token = ParserAdvance(p);
+	ParserExpect(p, TOKEN_LEFT_PAREN, "'('");
+
+	U32 init = AST_NULL;
+	if (ParserPeek(p) != TOKEN_SEMICOLON) init = ParseExpression(p, PRECEDENCE_ASSIGN);
+	ParserExpect(p, TOKEN_SEMICOLON, "';'");
+
+	U32 condition = AST_NULL;
+	if (ParserPeek(p) != TOKEN_SEMICOLON) condition = ParseExpression(p, PRECEDENCE_ASSIGN);
+	ParserExpect(p, TOKEN_SEMICOLON, "';'");
+
+	U32 step = AST_NULL;
+	if (ParserPeek(p) != TOKEN_RIGHT_PAREN) step = ParseExpression(p, PRECEDENCE_ASSIGN);
+	ParserExpect(p, TOKEN_RIGHT_PAREN, "')'");
+
+	U32 clauses = p->ast->extra.count;
+	AstExtraVec_Push(&p->ast->extra, init);
+	AstExtraVec_Push(&p->ast->extra, condition);
+	AstExtraVec_Push(&p->ast->extra, step);
+
+	U32 body = ParseBlock(p);
+	return Ast_AddNode(p->ast, AST_FOR, token, clauses, body);
+}
+
+/* AST_NULL for an empty statement */
+static U32 ParseStatement(ParserInfo* p) {
+	U32 statement;
+	switch (ParserPeek(p)) {
+		case TOKEN_FUNC:
+			statement = ParseFunc(p);
+			break;
+		case TOKEN_IF:
+			statement = ParseIf(p);
+			break;
+		case TOKEN_WHILE:
+			statement = ParseWhile(p);
+			break;
+		case TOKEN_FOR:
+			statement = ParseFor(p);
+			break;
+		case TOKEN_LEFT_BRACE:
+			statement = ParseBlock(p);
+			break;
+		case TOKEN_SEMICOLON:
+			ParserAdvance(p);
+			return AST_NULL;
+		default:
+			statement = ParseExpression(p, PRECEDENCE_ASSIGN);
+			ParserExpect(p, TOKEN_SEMICOLON, "';'");
+			break;
+	}
+
+	if (p->recovering) ParserSynchronize(p);
+	return statement;
+}
+
+void CreateParseTree(CompilerInfo* info, ScannerPipe* pipe) {
+	ParserInfo parser = {0};
+	ParserInfo* p = &parser;
+	p->info = info;
+	p->ast = &info->ast;
+	p->tokens = info->tokens;
+	p->pipe = pipe;
+	/* the parser indexes the token arrays directly */
+	TokenBuffer_CloseGap(p->tokens);
+	AstExtraVec_Init(&p->scratch);
+
+	/* a little under one node per token, the stream length is only known up front without the pipe */
+	U32 expected_nodes = pipe != NULL ? TokenBuffer_EstimateCapacity(info->source.len) : info->tokens->count;
+	Ast_Init(p->ast, info->arena, expected_nodes);
+	U32 root = Ast_AddNode(p->ast, AST_FILE, 0, 0, 0);
+
+	ParserSkipIllegal(p);
+	while (ParserPeek(p) != TOKEN_EOF) {
+		/* a stray '}' ends nothing at file level, it would stall the loop */
+		if (ParserPeek(p) == TOKEN_RIGHT_BRACE) {
+			ParserError(p, p->current, "unmatched '}'");
+			ParserAdvance(p);
+			p->recovering = FALSE;
+			continue;
+		}
+		U32 statement = ParseStatement(p);
+		if (statement != AST_NULL) AstExtraVec_Push(&p->scratch, statement);
+	}
+
+	U32 first = ParserCommitList(p, 0);
+	p->ast->nodes.data[root].lhs = first;
+	p->ast->nodes.data[root].rhs = p->ast->extra.count;
+	AstExtraVec_Free(&p->scratch);
+
+	/* after giving up the rest of the stream still belongs in tokens */
+	if (pipe != NULL) {
+		while (p->tokens->kind[p->tokens->count - 1] != TOKEN_EOF) {
+			TokenBuffer_Push(p->tokens, ScannerPipe_Next(pipe));
+		}
+	}
+}
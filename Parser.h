@@ -0,0 +1,23 @@
+#pragma once
+#include "Common.h"
+#include "Ast.h"
+#include "Compiler.h"
+#include "Scanner.h"
+
+/* Errors reported per file before the parser gives up on the rest of it */
+#define PARSER_MAX_ERRORS 16
+/* Nesting of blocks and parenthesized expressions, keeps recursion off the end of the stack */
+#define PARSER_MAX_DEPTH 256
+
+/*
+	Recursive descent for statements, Pratt (precedence climbing) for expressions.
+	Builds info->ast in info->arena and reports syntax errors with CompilerError.
+
+	With pipe NULL the tokens are read from info->tokens, which must hold the
+	whole stream. Otherwise they are pulled from pipe as the parser needs them
+	and appended to info->tokens, so node token indices mean the same in both
+	modes and the buffer is complete once CreateParseTree returns.
+	ILLEGAL tokens are reported as the parser steps over them, the ones past
+	the point where it gives up on the file are not.
+*/
+void CreateParseTree(CompilerInfo* info, ScannerPipe* pipe);
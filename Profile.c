@@ -0,0 +1,248 @@
+#include "Profile.h"
+#include "Timer.h"
+#include "Thread.h"
+#include "Memory.h"
+#include "Output.h"
+#include "String.h"
+#include "Logger.h"
+
+#include <stdio.h>
+
+#define PROFILE_EVENTS_PER_CHUNK 4096
+#define PROFILE_MAX_PHASES       64
+#define PROFILE_THREAD_NAME_SIZE 32
+
+typedef struct profileevent_t {
+	const char* name;
+	const char* detail;
+	U64 start;
+	U64 duration;
+} ProfileEvent;
+
+/* Chunks never move once allocated, the owner thread only ever appends */
+typedef struct profilechunk_t {
+	struct profilechunk_t* next;
+	U32 count;
+	ProfileEvent events[PROFILE_EVENTS_PER_CHUNK];
+} ProfileChunk;
+
+typedef struct profilethread_t {
+	struct profilethread_t* next;
+	U32 id;
+	char name[PROFILE_THREAD_NAME_SIZE];
+	ProfileChunk* first;
+	ProfileChunk* last;
+} ProfileThread;
+
+typedef struct profilephase_t {
+	const char* name;
+	U64 count;
+	U64 total;
+	U64 max;
+} ProfilePhase;
+
+static Bool g_profileEnabled;
+static U64 g_profileOrigin;
+static Mutex* g_profileMutex;
+static ProfileThread* g_profileThreads;
+static U32 g_profileThreadCount;
+
+static THREAD_LOCAL ProfileThread* g_profileThread;
+
+void Profile_Init(Bool enabled) {
+	g_profileEnabled = enabled;
+	g_profileOrigin = Timer_Now();
+	if (enabled && g_profileMutex == NULL) {
+		g_profileMutex = Mutex_Create();
+	}
+}
+
+Bool Profile_IsEnabled(void) {
+	return g_profileEnabled;
+}
+
+static ProfileThread* ProfileGetThread(void) {
+	if (g_profileThread != NULL) return g_profileThread;
+
+	ProfileThread* thread = Malloc(sizeof(*thread));
+	if (thread == NULL) {
+		PANIC("Couldn't allocate profile thread");
+	}
+	thread->next = NULL;
+	thread->first = NULL;
+	thread->last = NULL;
+
+	/* appended so the report and the tracks come out in registration order */
+	Mutex_Lock(g_profileMutex);
+	thread->id = g_profileThreadCount++;
+	ProfileThread** link = &g_profileThreads;
+	while (*link != NULL) link = &(*link)->next;
+	*link = thread;
+	Mutex_Unlock(g_profileMutex);
+
+	snprintf(thread->name, sizeof(thread->name), "thread %u", thread->id);
+	g_profileThread = thread;
+	return thread;
+}
+
+void Profile_SetThreadName(const char* name, U32 index) {
+	if (!g_profileEnabled) return;
+
+	ProfileThread* thread = ProfileGetThread();
+	if (index == PROFILE_NO_INDEX) snprintf(thread->name, sizeof(thread->name), "%s", name);
+	else snprintf(thread->name, sizeof(thread->name), "%s %u", name, index);
+}
+
+ProfileScope Profile_Begin(const char* name, const char* detail) {
+	ProfileScope scope;
+	scope.name = name;
+	scope.detail = detail;
+	scope.start = g_profileEnabled ? Timer_Now() : 0;
+	return scope;
+}
+
+void Profile_End(const ProfileScope* scope) {
+	if (!g_profileEnabled) return;
+	U64 end = Timer_Now();
+
+	ProfileThread* thread = ProfileGetThread();
+	ProfileChunk* chunk = thread->last;
+	if (chunk == NULL || chunk->count == PROFILE_EVENTS_PER_CHUNK) {
+		chunk = Malloc(sizeof(*chunk));
+		if (chunk == NULL) {
+			PANIC("Couldn't allocate profile events");
+		}
+		chunk->next = NULL;
+		chunk->count = 0;
+		if (thread->last != NULL) thread->last->next = chunk;
+		else thread->first = chunk;
+		thread->last = chunk;
+	}
+
+	ProfileEvent* event = &chunk->events[chunk->count++];
+	event->name = scope->name;
+	event->detail = scope->detail;
+	event->start = scope->start;
+	event->duration = end - scope->start;
+}
+
+static ProfilePhase* ProfileFindPhase(ProfilePhase* phases, U32* phase_count, const char* name) {
+	for (U32 i = 0; i < *phase_count; i++) {
+		if (phases[i].name == name || StringCompare((const U8*)phases[i].name, (const U8*)name) == 0) {
+			return &phases[i];
+		}
+	}
+	if (*phase_count == PROFILE_MAX_PHASES) return NULL;
+
+	ProfilePhase* phase = &phases[(*phase_count)++];
+	phase->name = name;
+	phase->count = 0;
+	phase->total = 0;
+	phase->max = 0;
+	return phase;
+}
+
+void Profile_PrintReport(void) {
+	if (!g_profileEnabled) return;
+
+	U64 wall = Timer_Now() - g_profileOrigin;
+	ProfilePhase phases[PROFILE_MAX_PHASES];
+	U32 phase_count = 0;
+
+	for (ProfileThread* thread = g_profileThreads; thread != NULL; thread = thread->next) {
+		for (ProfileChunk* chunk = thread->first; chunk != NULL; chunk = chunk->next) {
+			for (U32 i = 0; i < chunk->count; i++) {
+				ProfileEvent* event = &chunk->events[i];
+				ProfilePhase* phase = ProfileFindPhase(phases, &phase_count, event->name);
+				if (phase == NULL) continue;
+				phase->count++;
+				phase->total += event->duration;
+				if (event->duration > phase->max) phase->max = event->duration;
+			}
+		}
+	}
+
+	/* totals add up time from every thread, so they can exceed the wall time */
+	Print("\n==== time report (wall %.3f ms, %u threads) ====\n", (double)wall / 1e6, g_profileThreadCount);
+	Print("%-20s %10s %14s %12s %12s\n", "phase", "count", "total ms", "mean us", "max us");
+	for (U32 i = 0; i < phase_count; i++) {
+		ProfilePhase* phase = &phases[i];
+		Print("%-20s %10llu %14.3f %12.3f %12.3f\n", phase->name, (unsigned long long)phase->count,
+			(double)phase->total / 1e6, (double)phase->total / 1e3 / (double)phase->count, (double)phase->max / 1e3);
+	}
+}
+
+static void ProfileWriteEscaped(Output* json, const char* text) {
+	for (; *text != '\0'; text++) {
+		U8 c = (U8)*text;
+		if (c == '"' || c == '\\') {
+			Output_WriteChar(json, '\\');
+			Output_WriteChar(json, c);
+		}
+		else if (c < 0x20) Output_Format(json, "\\u%04x", c);
+		else Output_WriteChar(json, c);
+	}
+}
+
+Bool Profile_WriteTrace(const char* path) {
+	if (!g_profileEnabled) return FALSE;
+
+	Output json;
+	if (!Output_OpenFile(&json, path)) return FALSE;
+	Output_WriteString(&json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	Bool first = TRUE;
+	for (ProfileThread* thread = g_profileThreads; thread != NULL; thread = thread->next) {
+		Output_Format(&json, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+			first ? "" : ",\n", thread->id);
+		ProfileWriteEscaped(&json, thread->name);
+		Output_WriteString(&json, "\"}}");
+		Output_Format(&json, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}",
+			thread->id, thread->id);
+		first = FALSE;
+
+		for (ProfileChunk* chunk = thread->first; chunk != NULL; chunk = chunk->next) {
+			for (U32 i = 0; i < chunk->count; i++) {
+				ProfileEvent* event = &chunk->events[i];
+				/* timestamps are microseconds since Profile_Init */
+				Output_WriteString(&json, ",\n{\"name\":\"");
+				ProfileWriteEscaped(&json, event->name);
+				Output_Format(&json, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+					thread->id, (double)(event->start - g_profileOrigin) / 1e3, (double)event->duration / 1e3);
+				if (event->detail != NULL) {
+					Output_WriteString(&json, ",\"args\":{\"detail\":\"");
+					ProfileWriteEscaped(&json, event->detail);
+					Output_WriteString(&json, "\"}");
+				}
+				Output_WriteChar(&json, '}');
+			}
+		}
+	}
+	Output_WriteString(&json, "\n]}\n");
+
+	return Output_Close(&json);
+}
+
+void Profile_Shutdown(void) {
+	ProfileThread* thread = g_profileThreads;
+	while (thread != NULL) {
+		ProfileThread* next = thread->next;
+		ProfileChunk* chunk = thread->first;
+		while (chunk != NULL) {
+			ProfileChunk* next_chunk = chunk->next;
+			Free(chunk);
+			chunk = next_chunk;
+		}
+		Free(thread);
+		thread = next;
+	}
+
+	g_profileThreads = NULL;
+	g_profileThreadCount = 0;
+	g_profileThread = NULL;
+	g_profileEnabled = FALSE;
+	if (g_profileMutex != NULL) {
+		Mutex_Destroy(g_profileMutex);
+		g_profileMutex = NULL;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Common.h"
+
+/*
+	Scoped timing for the compiler phases.
+	Every thread records into its own event buffer, so a scope costs two clock
+	reads and no locking. Scopes must end on the thread that began them.
+	While profiling is disabled Profile_Begin/Profile_End only test a flag.
+*/
+typedef struct profilescope_t {
+	const char* name;       // string literal, used as the event and report key
+	const char* detail;     // optional (file path, chunk), must outlive the report
+	U64 start;
+} ProfileScope;
+
+void Profile_Init(Bool enabled);
+Bool Profile_IsEnabled(void);
+
+/* Shown as the track name in the trace, index is appended when it isn't PROFILE_NO_INDEX */
+#define PROFILE_NO_INDEX 0xFFFFFFFF
+void Profile_SetThreadName(const char* name, U32 index);
+
+ProfileScope Profile_Begin(const char* name, const char* detail);
+void Profile_End(const ProfileScope* scope);
+
+/* Per-phase totals over every thread, printed with Print */
+void Profile_PrintReport(void);
+/* Chrome trace-event JSON (chrome://tracing, Perfetto), one track per thread */
+Bool Profile_WriteTrace(const char* path);
+
+/* Frees every thread's buffer, only call once the recording threads are done */
+void Profile_Shutdown(void);
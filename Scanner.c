@@ -1,110 +1,222 @@
 #include "Scanner.h"
 #include "Memory.h"
 #include "String.h"
+#include "ScannerKernels.h"
+#include "Keyword.h"
+#include "ScannerNumber.h"
+#include "ScannerTables.h"
+#include "Logger.h"
 
 
 
-ScannerToken ScannerGetNextToken(U8* data, U32* cursor);
+static Token ScannerGetNextToken(ScannerInfo* sInfo);
 
-ScannerInfo ScannerInit(U8* data, Array_Type tokens) {	
-	return (ScannerInfo) {.data=data, .cursor= 0, .tokens= tokens};
+static ScannerMode g_scannerMode = SCANNER_MODE_SWITCH;
+
+void Scanner_SetMode(ScannerMode mode) {
+	g_scannerMode = mode;
+}
+
+ScannerInfo ScannerInit(StrView source, TokenBuffer* tokens, Interner* interner) {	
+	return (ScannerInfo) {.source= source, .cursor= 0, .end= SCANNER_NO_END, .tokens= tokens, .interner= interner};
 }
 
-void ScannerTokenize(U8* data, Array_Type tokens_arr) {
-	if (data == NULL) return;
+void ScannerTokenize(StrView source, TokenBuffer* tokens, Interner* interner) {
+	if (source.ptr == NULL) return;
 	
-	ScannerInfo sInfo = ScannerInit(data, tokens_arr);
+	ScannerInfo sInfo = ScannerInit(source, tokens, interner);
+	ScannerTokenizeRange(&sInfo);
+}
 
-	ScannerToken current_token;
-	while (sInfo.status == SCANNER_RUNNING) {
-		current_token = ScannerGetNextToken(data, &sInfo.cursor);
+void ScannerTokenizeRange(ScannerInfo* sInfo) {
+	Token current_token;
+	while (sInfo->status == SCANNER_RUNNING) {
+		current_token = ScannerGetNextToken(sInfo);
 		
+		/* the token belongs to whoever scans from end, leave the cursor on it */
+		if (current_token.start >= sInfo->end && current_token.kind != TOKEN_EOF) {
+			sInfo->cursor = current_token.start;
+			sInfo->status = SCANNER_QUIT;
+			break;
+		}
 		
-		Array_Push(tokens_arr, current_token);
+		TokenBuffer_Push(sInfo->tokens, current_token);
 		
-		if (current_token->kind == TOKEN_EOF) {
-			sInfo.status = SCANNER_QUIT;
+		if (current_token.kind == TOKEN_EOF) {
+			sInfo->status = SCANNER_QUIT;
 		}
 	}
 
-	if (sInfo.status == SCANNER_CRASH) {
+	if (sInfo->status == SCANNER_CRASH) {
 		
 	}
+}
 
-	Array_Print(tokens_arr);
+Token ScannerScanToken(ScannerInfo* sInfo) {
+	return ScannerGetNextToken(sInfo);
 }
 
+Token Scanner_Next(ScannerInfo* sInfo) {
+	if (sInfo->lookahead_count == 0) return ScannerGetNextToken(sInfo);
 
+	Token token = sInfo->lookahead[sInfo->lookahead_head];
+	sInfo->lookahead_head = (sInfo->lookahead_head + 1) & SCANNER_LOOKAHEAD_MASK;
+	sInfo->lookahead_count--;
+	return token;
+}
 
-void ScannerTokenFree(ScannerToken t) {
-	Free(t->literal);
-	Free(t);
+Token Scanner_Peek(ScannerInfo* sInfo, U32 n) {
+	if (n >= SCANNER_LOOKAHEAD_SIZE) {
+		PANIC("Scanner_Peek(%u) is past the lookahead window", n);
+	}
+
+	/* past the end the scanner keeps producing EOF, so the window always fills */
+	while (sInfo->lookahead_count <= n) {
+		U32 tail = (sInfo->lookahead_head + sInfo->lookahead_count) & SCANNER_LOOKAHEAD_MASK;
+		sInfo->lookahead[tail] = ScannerGetNextToken(sInfo);
+		sInfo->lookahead_count++;
+	}
+	return sInfo->lookahead[(sInfo->lookahead_head + n) & SCANNER_LOOKAHEAD_MASK];
 }
 
-static const U8* TokenKindPrintTable[TOKEN_COUNT] = {
-	[TOKEN_NONE] = {"None"},
-	[TOKEN_LEFT_PAREN] = {"LEFT_PAREN"},
-	[TOKEN_RIGHT_PAREN] = {"RIGHT_PAREN"},
-	[TOKEN_LEFT_BRACE] = {"LEFT_BRACE"},
-	[TOKEN_RIGHT_BRACE] = {"RIGHT_BRACE"},
-	[TOKEN_MUL] = {"MUL"},
-	[TOKEN_DIV] = {"DIV"},
-	[TOKEN_PLUS] = {"PLUS"},
-	[TOKEN_MINUS] = {"MINUS"},
-	[TOKEN_LITERAL] = {"LITERAL"},
-	[TOKEN_NUMERIC] = {"NUMERIC"},
-	[TOKEN_SEMICOLON] = {"SEMICOLON"},
-	[TOKEN_COLON] = {"COLON"},
-	[TOKEN_COMMA] = {"COMMA"},
-	[TOKEN_LESS_THAN] = {"LESS_THAN"},
-	[TOKEN_GREATER_THAN] = {"GREATER_THAN"},
-	[TOKEN_EQUAL] = {"EQUAL"},
-	[TOKEN_AT] = {"AT"},
-
-	[TOKEN_IDENTIFIER] = {"IDENTIFIER"},
-	[TOKEN_FUNC] = {"FUNC"},
-	[TOKEN_FOR] = {"FOR"},
-	[TOKEN_WHILE] = {"WHILE"},
-	[TOKEN_IF] = {"IF"},
-	[TOKEN_ELSE] = {"ELSE"},
-
-	[TOKEN_DOUBLE_QUOTE] = {"\""},
-	[TOKEN_SINGLE_QUOTE] = {"\'"},
-
-	[TOKEN_ILLEGAL] = {"ILLEGAL"},
-	[TOKEN_ERROR] = {"ERROR"},
-	[TOKEN_EOF] = {"EOF"},
-};
-
-void ScannerTokenPrint(ScannerToken t){
-	Print("{ Kind: %s, Value: %s }\n", TokenKindPrintTable[t->kind], t->literal);
+
+static Token TokenCreate(TokenKind kind, U32 start, U32 length) {
+	return (Token) {.kind= kind, .start= start, .length= length, .value= 0};
 }
 
+static Token TokenCreateIllegal(ScannerError error, U32 start, U32 length) {
+	return (Token) {.kind= TOKEN_ILLEGAL, .start= start, .length= length, .value= error};
+}
 
-static ScannerToken TokenCreate(TokenKind kind, U8* literal) {
-	ScannerToken token = Malloc(sizeof(*token));
-	
-	token->kind = kind;
-	token->literal = literal;
+static U32 SkipWhiteSpace(const U8* data, U32 cursor) {
+	return g_scannerKernels.skip_whitespace(data, cursor);
+}
 
-	return token;
+/* cursor is past the comment opener, FALSE if the comment is never closed, cursor is then on the terminator */
+static Bool SkipBlockComment(const U8* data, U32* cursor) {
+	U32 position = *cursor;
+	for (;;) {
+		position = g_scannerKernels.scan_block_comment(data, position);
+		if (data[position] == '\0') {
+			*cursor = position;
+			return FALSE;
+		}
+		position++;
+		if (data[position] == '/') {
+			*cursor = position + 1;
+			return TRUE;
+		}
+	}
 }
 
-static U32 SkipWhiteSpace(U8* data, U32 cursor) {
-	U32 tmp = cursor;
+U32 ScannerSkipTrivia(const U8* data, U32 cursor) {
 	for (;;) {
-		char c = data[tmp];
-		switch (c) {
-		case ' ':
-		case '\r':
-		case '\t':
-		case '\n':
-			tmp++;
-			break;
-		default:
-			return tmp;
+		cursor = SkipWhiteSpace(data, cursor);
+		if (data[cursor] != '/') return cursor;
+
+		if (data[cursor + 1] == '/') {
+			cursor = g_scannerKernels.scan_line_comment(data, cursor + 2);
+		}
+		else if (data[cursor + 1] == '*') {
+			U32 end = cursor + 2;
+			if (!SkipBlockComment(data, &end)) return cursor;
+			cursor = end;
+		}
+		else {
+			return cursor;
+		}
+	}
+}
+
+/* Value of the character after a backslash, -1 for an unknown escape */
+static S32 DecodeEscape(U8 c) {
+	switch (c) {
+		case 'n': return '\n';
+		case 't': return '\t';
+		case 'r': return '\r';
+		case '0': return '\0';
+		case '\\': return '\\';
+		case '\'': return '\'';
+		case '"': return '"';
+	}
+	return -1;
+}
+
+/*
+	start is on the opening quote. The body is skipped a vector at a time up to
+	the next quote, backslash or newline, only the escapes are decoded one by
+	one. Literals end at the line, a newline before the closing quote leaves
+	the literal unterminated.
+*/
+static Token ScanQuoted(ScannerInfo* sInfo, U32 start) {
+	const U8* data = sInfo->source.ptr;
+	Bool is_char = data[start] == '\'';
+	U8 quote = data[start];
+	ScanRunFn scan_body = is_char ? g_scannerKernels.scan_char_body : g_scannerKernels.scan_string_body;
+
+	U32 cursor = start + 1;
+	U32 characters = 0;
+	U32 last_character = 0;
+	Bool bad_escape = FALSE;
+	for (;;) {
+		U32 stop = scan_body(data, cursor);
+		if (stop != cursor) {
+			characters += stop - cursor;
+			last_character = data[stop - 1];
+		}
+		cursor = stop;
+
+		if (data[cursor] == quote) break;
+		if (data[cursor] != '\\') {
+			sInfo->cursor = cursor;
+			return TokenCreateIllegal(is_char ? SCANNER_ERROR_UNTERMINATED_CHAR : SCANNER_ERROR_UNTERMINATED_STRING,
+				start, cursor - start);
+		}
+
+		/* a backslash at the end of the line doesn't continue the literal */
+		U8 escaped = data[cursor + 1];
+		if (escaped == '\n' || escaped == '\0') {
+			cursor++;
+			continue;
 		}
+		S32 decoded = DecodeEscape(escaped);
+		if (decoded < 0) bad_escape = TRUE;
+		characters++;
+		last_character = (U32)decoded;
+		cursor += 2;
 	}
+
+	cursor++;
+	sInfo->cursor = cursor;
+	if (bad_escape) return TokenCreateIllegal(SCANNER_ERROR_ESCAPE, start, cursor - start);
+	if (!is_char) return TokenCreate(TOKEN_STRING, start, cursor - start);
+	if (characters != 1) return TokenCreateIllegal(SCANNER_ERROR_CHAR_LENGTH, start, cursor - start);
+
+	Token token = TokenCreate(TOKEN_CHAR, start, cursor - start);
+	token.value = last_character;
+	return token;
+}
+
+/*
+	Tokens with a body rather than a spelling, both scanners try these before
+	their own rules. FALSE if the token at start isn't one of them.
+*/
+static Bool ScanBodyToken(ScannerInfo* sInfo, U32 start, Token* token) {
+	const U8* data = sInfo->source.ptr;
+	if (data[start] == '"' || data[start] == '\'') {
+		*token = ScanQuoted(sInfo, start);
+		return TRUE;
+	}
+
+	/* ScannerSkipTrivia only stops on a block comment that runs off the end */
+	if (data[start] == '/' && data[start + 1] == '*') {
+		U32 end = start + 2;
+		SkipBlockComment(data, &end);
+		sInfo->cursor = end;
+		*token = TokenCreateIllegal(SCANNER_ERROR_UNTERMINATED_COMMENT, start, end - start);
+		return TRUE;
+	}
+	return FALSE;
 }
 
 static Bool CharIsAlphabet(char c){
@@ -115,66 +227,75 @@ static Bool CharIsNumeric(char c) {
 	return c >= '0' && c <= '9';
 }
 
-static U8* ExtractString(const U8* data, U32 cursor, Size_t length) {
-	U8* buffer = Malloc(length + 1);
-	Memcpy(buffer, data + cursor, length);
-	buffer[length] = '\0';
-	return buffer;
-}
-
-static U8* ExtractNumber(const U8* data, U32* cursor) {
-	U32 last_cursor = *cursor;
-	while (CharIsNumeric(data[last_cursor])) {
-		last_cursor++;
-	}
+/* Advances the cursor past the run and returns where it started */
+static U32 ExtractLiteral(const U8* data, U32* cursor) {
+	U32 last_cursor = g_scannerKernels.scan_identifier(data, *cursor);
 	U32 first_cursor = *cursor;
 	*cursor = last_cursor;
-	return ExtractString(data, first_cursor, last_cursor - first_cursor);
+	return first_cursor;
 }
 
-static U8* ExtractLiteral(const U8* data, U32* cursor) {
-	U32 last_cursor = *cursor;
-	while (CharIsAlphabet(data[last_cursor])) {
-		last_cursor++;
-	}
-	U32 first_cursor = *cursor;
-	*cursor = last_cursor;
-	return ExtractString(data, first_cursor, last_cursor - first_cursor);
-}
+/*
+	Runs the ScannerTables.h DFA from the cursor and keeps the longest match.
+	The tables only know fixed spellings and runs, so after the match the token
+	is finished the same way the switch scanner finishes it.
+*/
+static Token ScannerGetNextTokenTable(ScannerInfo* sInfo) {
+	const U8* data = sInfo->source.ptr;
+	U32 start = ScannerSkipTrivia(data, sInfo->cursor);
+	sInfo->cursor = start;
 
+	if (data[start] == '\0') return TokenCreate(TOKEN_EOF, start, 0);
 
-static TokenKind GetLiteralKind(U8* literal) {
-	if (StringCompare(literal, "func") == 0) {
-		return TOKEN_FUNC;
-	}
+	Token body_token;
+	if (ScanBodyToken(sInfo, start, &body_token)) return body_token;
 
-	if (StringCompare(literal, "if") == 0) {
-		return TOKEN_IF;
-	}
+	/* anything the DFA can't start a token with is one ILLEGAL byte */
+	TokenKind kind = TOKEN_ILLEGAL;
+	U32 end = start + 1;
 
-	if (StringCompare(literal, "else") == 0) {
-		return TOKEN_ELSE;
+	U32 state = SCANNER_DFA_START;
+	U32 position = start;
+	for (;;) {
+		state = ScannerDfaNext[state][ScannerDfaClass[data[position]]];
+		if (state == SCANNER_DFA_DEAD) break;
+		position++;
+		if (ScannerDfaAccept[state] != TOKEN_NONE) {
+			kind = (TokenKind)ScannerDfaAccept[state];
+			end = position;
+		}
 	}
 
-	if (StringCompare(literal, "for") == 0) {
-		return TOKEN_FOR;
+	/* the DFA only knows the digit run, the literal itself is decoded like the switch scanner does it */
+	if (kind == TOKEN_NUMERIC) {
+		Token token = ScannerScanNumber(data, start, sInfo->interner);
+		sInfo->cursor = token.start + token.length;
+		return token;
 	}
 
-	if (StringCompare(literal, "while") == 0) {
-		return TOKEN_WHILE;
+	sInfo->cursor = end;
+	Token token = TokenCreate(kind, start, end - start);
+	if (kind == TOKEN_IDENTIFIER) {
+		token.value = Interner_Intern(sInfo->interner, StrView_Slice(sInfo->source, start, end - start));
 	}
-
-	return TOKEN_IDENTIFIER;
+	return token;
 }
 
-static ScannerToken ScannerGetNextToken(U8* data, U32* cursor) {
+static Token ScannerGetNextToken(ScannerInfo* sInfo) {
+	if (g_scannerMode == SCANNER_MODE_TABLE) return ScannerGetNextTokenTable(sInfo);
+
+	const U8* data = sInfo->source.ptr;
+	U32* cursor = &sInfo->cursor;
 	U32 next_token_length = 0;
 
-	U32 next_cursor = SkipWhiteSpace(data, *cursor);
+	U32 next_cursor = ScannerSkipTrivia(data, *cursor);
 	*cursor = next_cursor;
 	char current_char = data[next_cursor];
 	
-	if (current_char == '\0') return TokenCreate(TOKEN_EOF, NULL);
+	if (current_char == '\0') return TokenCreate(TOKEN_EOF, next_cursor, 0);
+
+	Token body_token;
+	if (ScanBodyToken(sInfo, next_cursor, &body_token)) return body_token;
 	
 	TokenKind current_kind = TOKEN_NONE;
 	switch (current_char) {
@@ -220,43 +341,54 @@ static ScannerToken ScannerGetNextToken(U8* data, U32* cursor) {
 		case '=':
 			current_kind = TOKEN_EQUAL;
 			break;
+		case '!':
+			if (data[next_cursor + 1] == '=') current_kind = TOKEN_BANG_EQUAL;
+			break;
 		case '@':
 			current_kind = TOKEN_AT;
 			break;
-		case '\"':
-			current_kind = TOKEN_DOUBLE_QUOTE;
-			break;
-		case '\'':
-			current_kind = TOKEN_SINGLE_QUOTE;
-			break;
+	}
+
+	/* two-character operators, the second character is at worst the NUL terminator */
+	if (data[next_cursor + 1] == '=') {
+		if (current_kind == TOKEN_EQUAL) current_kind = TOKEN_EQUAL_EQUAL;
+		else if (current_kind == TOKEN_LESS_THAN) current_kind = TOKEN_LESS_EQUAL;
+		else if (current_kind == TOKEN_GREATER_THAN) current_kind = TOKEN_GREATER_EQUAL;
+	}
+	else if (data[next_cursor + 1] == '>' && current_kind == TOKEN_MINUS) {
+		current_kind = TOKEN_ARROW;
 	}
 
 	if (current_kind != TOKEN_NONE) {
-		*cursor = *cursor + 1;
-		
-		U8* allocated_char = Malloc(sizeof(char) * 2);
-		allocated_char[0] = current_char;
-		allocated_char[1] = '\0';
+		U32 length = current_kind >= TOKEN_EQUAL_EQUAL && current_kind <= TOKEN_ARROW ? 2 : 1;
+		*cursor = *cursor + length;
 
-		return TokenCreate(current_kind, allocated_char);
+		return TokenCreate(current_kind, next_cursor, length);
 	}
 
 
 	if (CharIsAlphabet(current_char)) {
-		U8* literal = ExtractLiteral(data, cursor);		
-		TokenKind literal_kind = GetLiteralKind(literal);
+		U32 start = ExtractLiteral(data, cursor);		
+		U32 length = *cursor - start;
+		StrView literal = StrView_Slice(sInfo->source, start, length);
+		TokenKind literal_kind = KeywordLookup(literal);
 		
-		return TokenCreate(literal_kind, literal);
+		Token token = TokenCreate(literal_kind, start, length);
+		if (literal_kind == TOKEN_IDENTIFIER) {
+			token.value = Interner_Intern(sInfo->interner, literal);
+		}
+		return token;
 	}
 
 	if (CharIsNumeric(current_char)) {
-		U8* literal = ExtractNumber(data, cursor);
-		return TokenCreate(TOKEN_NUMERIC, literal);
+		Token token = ScannerScanNumber(data, next_cursor, sInfo->interner);
+		*cursor = token.start + token.length;
+		return token;
 	}
 
 
 
 	*cursor = *cursor + 1;
-	return TokenCreate(TOKEN_ILLEGAL, NULL);
+	return TokenCreateIllegal(SCANNER_ERROR_CHARACTER, next_cursor, 1);
 }
 
@@ -1,6 +1,9 @@
 #pragma once
 #include "Common.h"
-#include "Array.h"
+#include "Token.h"
+#include "Intern.h"
+#include "String.h"
+#include "ThreadPool.h"
 
 typedef enum {
 	SCANNER_RUNNING,
@@ -8,62 +11,125 @@ typedef enum {
 	SCANNER_QUIT,
 } ScannerStatus;
 
+#define SCANNER_NO_END 0xFFFFFFFF
+
+/* How far Scanner_Peek can look ahead, a power of two */
+#define SCANNER_LOOKAHEAD_SIZE 8
+#define SCANNER_LOOKAHEAD_MASK (SCANNER_LOOKAHEAD_SIZE - 1)
+
 typedef struct scanner_t {
-	U8* data;
+	StrView source;             // source.ptr[source.len] must be the NUL terminator
 	U32 cursor;
-	Array_Type tokens;
+	U32 end;                    // scanning stops at the first token starting at or after end
+	TokenBuffer* tokens;
+	Interner* interner;         // identifiers are interned as they are scanned
 	ScannerStatus status;
+	Token lookahead[SCANNER_LOOKAHEAD_SIZE];    // scanned by Scanner_Peek, not returned by Scanner_Next yet
+	U32 lookahead_head;
+	U32 lookahead_count;
 } ScannerInfo;
 
+/*
+	How tokens are recognized. SWITCH is the hand-written scanner, TABLE runs
+	the DFA that Tools/LexGen.c generates into ScannerTables.h from the token
+	spec. Both produce the same tokens, the mode only exists to compare them.
+*/
+typedef enum {
+	SCANNER_MODE_SWITCH,
+	SCANNER_MODE_TABLE,
+} ScannerMode;
+
+/* Process-wide, set it before any scanning starts */
+void Scanner_SetMode(ScannerMode mode);
+
+/* Why a TOKEN_ILLEGAL token is illegal, kept in its value */
 typedef enum {
-	TOKEN_NONE,
-	TOKEN_LEFT_PAREN,
-	TOKEN_RIGHT_PAREN,
-	TOKEN_LEFT_BRACE,
-	TOKEN_RIGHT_BRACE,
-	TOKEN_MUL,
-	TOKEN_DIV,
-	TOKEN_PLUS,
-	TOKEN_MINUS,
-	TOKEN_LITERAL,
-	TOKEN_NUMERIC,
-	TOKEN_SEMICOLON,
-	TOKEN_COLON,
-	TOKEN_COMMA,
-	TOKEN_LESS_THAN,
-	TOKEN_GREATER_THAN,
-	TOKEN_EQUAL,
-	TOKEN_AT,
-
-	TOKEN_IDENTIFIER,
-	TOKEN_FUNC,
-	TOKEN_FOR,
-	TOKEN_WHILE,
-	TOKEN_IF,
-	TOKEN_ELSE,
-
-	TOKEN_DOUBLE_QUOTE,
-	TOKEN_SINGLE_QUOTE,
-
-	TOKEN_ILLEGAL,
-	TOKEN_ERROR,
-	TOKEN_EOF,
-	TOKEN_COUNT
-} TokenKind;
-
-
-#ifndef TOKEN_PRINT_TABLE
-#define TOKEN_PRINT_TABLE
-
-#endif
-
-typedef struct scannertoken_t {
-	TokenKind kind;
-	U8* literal;
-}* ScannerToken;
-
-ScannerInfo ScannerInit(U8* data, Array_Type tokens);
-void ScannerTokenize(U8* data, Array_Type tokens_arr);
-
-void ScannerTokenFree(ScannerToken t);
-void ScannerTokenPrint(ScannerToken t);
\ No newline at end of file
+	SCANNER_ERROR_CHARACTER,                // one byte no token starts with
+	SCANNER_ERROR_UNTERMINATED_STRING,      // runs up to the end of the line
+	SCANNER_ERROR_UNTERMINATED_CHAR,
+	SCANNER_ERROR_UNTERMINATED_COMMENT,     // runs up to the end of the file
+	SCANNER_ERROR_ESCAPE,                   // a literal with an unknown escape, the whole literal
+	SCANNER_ERROR_CHAR_LENGTH,              // a char literal that isn't exactly one character
+	SCANNER_ERROR_NUMBER_OVERFLOW,          // an integer past 64 bits or a float past the double range
+	SCANNER_ERROR_NUMBER_MALFORMED,         // a misplaced '_' or a digit outside the literal's base
+} ScannerError;
+
+ScannerInfo ScannerInit(StrView source, TokenBuffer* tokens, Interner* interner);
+void ScannerTokenize(StrView source, TokenBuffer* tokens, Interner* interner);
+
+/* Scans from sInfo->cursor up to sInfo->end into sInfo->tokens, the last token may extend past end */
+void ScannerTokenizeRange(ScannerInfo* sInfo);
+/* Scans exactly one token at sInfo->cursor (whitespace and comments are skipped first), bypasses the lookahead */
+Token ScannerScanToken(ScannerInfo* sInfo);
+/* Skips whitespace and comments, stops on the '/' of a block comment that is never closed */
+U32 ScannerSkipTrivia(const U8* data, U32 cursor);
+
+/*
+	Pull interface, tokens are scanned on demand and nothing is stored beyond
+	the lookahead window, sInfo->tokens isn't used and may be NULL.
+	Scanner_Next keeps returning the EOF token once the source is exhausted.
+	The cursor runs ahead of Scanner_Next by however many tokens were peeked.
+*/
+Token Scanner_Next(ScannerInfo* sInfo);
+/* The token n places after the next one, Scanner_Peek(sInfo, 0) is what Scanner_Next returns. n < SCANNER_LOOKAHEAD_SIZE */
+Token Scanner_Peek(ScannerInfo* sInfo, U32 n);
+
+/*
+	Splits source into chunks at whitespace boundaries, scans them on the pool and
+	stitches the per-chunk streams back together. A boundary that turns out to
+	sit inside a token is repaired by rescanning serially until the streams meet
+	again, so the result is identical to ScannerTokenize, symbol ids included.
+*/
+void ScannerTokenizeParallel(StrView source, TokenBuffer* tokens, Interner* interner,
+	ThreadPool* pool, U32 chunk_count);
+
+/*
+	Pipeline mode: a dedicated thread scans source into batches of tokens and
+	publishes them through a single-producer/single-consumer ring, the consumer
+	pulls them with ScannerPipe_Next. A full ring stalls the scanner until the
+	consumer catches up, so memory stays bounded by the ring.
+	The scanner thread owns interner and the arena it allocates from until
+	ScannerPipe_Finish. Until then the consumer may use symbol and constant ids
+	but must not look names or constants up, intern anything or allocate from
+	that arena.
+*/
+#define SCANNER_PIPE_BATCH_SIZE 256     // tokens per batch, 4 KiB
+#define SCANNER_PIPE_RING_SIZE  32      // batches, a power of two
+
+typedef struct scannerpipe_t ScannerPipe;
+
+/* NULL if the scanner thread couldn't be started */
+ScannerPipe* ScannerPipe_Start(StrView source, Interner* interner);
+/* Same contract as Scanner_Next, the EOF token repeats once the source is exhausted */
+Token ScannerPipe_Next(ScannerPipe* pipe);
+/* Stops the scanner thread (even if the consumer didn't reach EOF) and releases the pipe */
+void ScannerPipe_Finish(ScannerPipe* pipe);
+
+/*
+	Incremental re-lexing for edited buffers. The caller edits its source in
+	place (tokens are spans into it, so the scanner never sees the edit text on
+	its own) and describes the edit in old-source offsets. Tokens are rescanned
+	from the last one the edit can't have changed until the new stream lands on
+	a start the old one also had past the edit, the rest of the old stream is
+	kept with its offsets shifted. The result equals a full ScannerTokenize of
+	the new source except for ids: new names get fresh symbols and rescanned
+	numbers append fresh constants, the ones they replace are left unused.
+	The work follows the size of the edit and its distance from the previous
+	one, not the file: the buffer is left with its gap at the edit (see
+	TokenBuffer) and the shift of everything after it pending.
+*/
+typedef struct scanneredit_t {
+	U32 offset;             // where the edit starts
+	U32 removed;            // bytes removed at offset
+	U32 inserted;           // bytes now in their place
+} ScannerEdit;
+
+/* Token indices the edit touched, in the updated buffer */
+typedef struct scannerrelexresult_t {
+	U32 first;              // first rescanned token
+	U32 removed;            // old tokens dropped from first on
+	U32 inserted;           // new tokens in their place
+} ScannerRelexResult;
+
+/* tokens must hold the full stream of the old source, source is the edited one with its terminator */
+ScannerRelexResult ScannerRelex(TokenBuffer* tokens, Interner* interner, StrView source, ScannerEdit edit);
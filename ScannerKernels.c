@@ -0,0 +1,243 @@
+#include "ScannerKernels.h"
+#include "Simd.h"
+
+#define CHAR_CLASS_WHITESPACE (1 << 0)
+#define CHAR_CLASS_ALPHABET   (1 << 1)
+#define CHAR_CLASS_DIGIT      (1 << 2)
+
+/* Bytes that end a literal or comment body, the terminator ends all of them */
+#define CHAR_STOP_STRING      (1 << 3)
+#define CHAR_STOP_CHAR        (1 << 4)
+#define CHAR_STOP_LINE        (1 << 5)
+#define CHAR_STOP_BLOCK       (1 << 6)
+
+static const U8 CharClassTable[256] = {
+	['\0'] = CHAR_STOP_STRING | CHAR_STOP_CHAR | CHAR_STOP_LINE | CHAR_STOP_BLOCK,
+	['\n'] = CHAR_CLASS_WHITESPACE | CHAR_STOP_STRING | CHAR_STOP_CHAR | CHAR_STOP_LINE,
+	['"'] = CHAR_STOP_STRING, ['\''] = CHAR_STOP_CHAR,
+	['\\'] = CHAR_STOP_STRING | CHAR_STOP_CHAR, ['*'] = CHAR_STOP_BLOCK,
+
+	[' '] = CHAR_CLASS_WHITESPACE, ['\t'] = CHAR_CLASS_WHITESPACE,
+	['\r'] = CHAR_CLASS_WHITESPACE,
+
+	['0'] = CHAR_CLASS_DIGIT, ['1'] = CHAR_CLASS_DIGIT, ['2'] = CHAR_CLASS_DIGIT,
+	['3'] = CHAR_CLASS_DIGIT, ['4'] = CHAR_CLASS_DIGIT, ['5'] = CHAR_CLASS_DIGIT,
+	['6'] = CHAR_CLASS_DIGIT, ['7'] = CHAR_CLASS_DIGIT, ['8'] = CHAR_CLASS_DIGIT,
+	['9'] = CHAR_CLASS_DIGIT,
+
+	['a'] = CHAR_CLASS_ALPHABET, ['b'] = CHAR_CLASS_ALPHABET, ['c'] = CHAR_CLASS_ALPHABET,
+	['d'] = CHAR_CLASS_ALPHABET, ['e'] = CHAR_CLASS_ALPHABET, ['f'] = CHAR_CLASS_ALPHABET,
+	['g'] = CHAR_CLASS_ALPHABET, ['h'] = CHAR_CLASS_ALPHABET, ['i'] = CHAR_CLASS_ALPHABET,
+	['j'] = CHAR_CLASS_ALPHABET, ['k'] = CHAR_CLASS_ALPHABET, ['l'] = CHAR_CLASS_ALPHABET,
+	['m'] = CHAR_CLASS_ALPHABET, ['n'] = CHAR_CLASS_ALPHABET, ['o'] = CHAR_CLASS_ALPHABET,
+	['p'] = CHAR_CLASS_ALPHABET, ['q'] = CHAR_CLASS_ALPHABET, ['r'] = CHAR_CLASS_ALPHABET,
+	['s'] = CHAR_CLASS_ALPHABET, ['t'] = CHAR_CLASS_ALPHABET, ['u'] = CHAR_CLASS_ALPHABET,
+	['v'] = CHAR_CLASS_ALPHABET, ['w'] = CHAR_CLASS_ALPHABET, ['x'] = CHAR_CLASS_ALPHABET,
+	['y'] = CHAR_CLASS_ALPHABET, ['z'] = CHAR_CLASS_ALPHABET,
+
+	['A'] = CHAR_CLASS_ALPHABET, ['B'] = CHAR_CLASS_ALPHABET, ['C'] = CHAR_CLASS_ALPHABET,
+	['D'] = CHAR_CLASS_ALPHABET, ['E'] = CHAR_CLASS_ALPHABET, ['F'] = CHAR_CLASS_ALPHABET,
+	['G'] = CHAR_CLASS_ALPHABET, ['H'] = CHAR_CLASS_ALPHABET, ['I'] = CHAR_CLASS_ALPHABET,
+	['J'] = CHAR_CLASS_ALPHABET, ['K'] = CHAR_CLASS_ALPHABET, ['L'] = CHAR_CLASS_ALPHABET,
+	['M'] = CHAR_CLASS_ALPHABET, ['N'] = CHAR_CLASS_ALPHABET, ['O'] = CHAR_CLASS_ALPHABET,
+	['P'] = CHAR_CLASS_ALPHABET, ['Q'] = CHAR_CLASS_ALPHABET, ['R'] = CHAR_CLASS_ALPHABET,
+	['S'] = CHAR_CLASS_ALPHABET, ['T'] = CHAR_CLASS_ALPHABET, ['U'] = CHAR_CLASS_ALPHABET,
+	['V'] = CHAR_CLASS_ALPHABET, ['W'] = CHAR_CLASS_ALPHABET, ['X'] = CHAR_CLASS_ALPHABET,
+	['Y'] = CHAR_CLASS_ALPHABET, ['Z'] = CHAR_CLASS_ALPHABET,
+};
+
+static U32 ScanClassScalar(const U8* data, U32 cursor, U8 char_class) {
+	while (CharClassTable[data[cursor]] & char_class) {
+		cursor++;
+	}
+	return cursor;
+}
+
+static U32 SkipWhiteSpaceScalar(const U8* data, U32 cursor) {
+	return ScanClassScalar(data, cursor, CHAR_CLASS_WHITESPACE);
+}
+
+static U32 ScanIdentifierScalar(const U8* data, U32 cursor) {
+	return ScanClassScalar(data, cursor, CHAR_CLASS_ALPHABET);
+}
+
+static U32 ScanDigitsScalar(const U8* data, U32 cursor) {
+	return ScanClassScalar(data, cursor, CHAR_CLASS_DIGIT);
+}
+
+static U32 ScanUntilScalar(const U8* data, U32 cursor, U8 stop_class) {
+	while (!(CharClassTable[data[cursor]] & stop_class)) {
+		cursor++;
+	}
+	return cursor;
+}
+
+static U32 ScanStringBodyScalar(const U8* data, U32 cursor) {
+	return ScanUntilScalar(data, cursor, CHAR_STOP_STRING);
+}
+
+static U32 ScanCharBodyScalar(const U8* data, U32 cursor) {
+	return ScanUntilScalar(data, cursor, CHAR_STOP_CHAR);
+}
+
+static U32 ScanLineCommentScalar(const U8* data, U32 cursor) {
+	return ScanUntilScalar(data, cursor, CHAR_STOP_LINE);
+}
+
+static U32 ScanBlockCommentScalar(const U8* data, U32 cursor) {
+	return ScanUntilScalar(data, cursor, CHAR_STOP_BLOCK);
+}
+
+ScannerKernels g_scannerKernels = {
+	.skip_whitespace = SkipWhiteSpaceScalar,
+	.scan_identifier = ScanIdentifierScalar,
+	.scan_digits = ScanDigitsScalar,
+	.scan_string_body = ScanStringBodyScalar,
+	.scan_char_body = ScanCharBodyScalar,
+	.scan_line_comment = ScanLineCommentScalar,
+	.scan_block_comment = ScanBlockCommentScalar,
+	.name = (const U8*)"scalar",
+};
+
+#ifdef SIMD_X86
+
+/*
+	SSE4.2: PCMPISTRI with negative polarity returns the index of the first byte
+	outside the set, and treats the implicit NUL terminator as outside too.
+	A load that would cross into the next page finishes the page scalar instead,
+	stopping where (class bits & char_class) == stop_value: 0 for a run of the
+	class, char_class for a run up to the first byte of a stop class.
+*/
+#define SSE42_SCAN_RUN(name, set_literal, mode, char_class, stop_value)              \
+SIMD_TARGET_SSE42 SIMD_NO_SANITIZE static U32 name(const U8* data, U32 cursor) {     \
+	const __m128i set = _mm_loadu_si128((const __m128i*)set_literal);                 \
+	for (;;) {                                                                        \
+		const U8* ptr = data + cursor;                                                \
+		if (!SIMD_LOAD_IS_SAFE(ptr, 16)) {                                            \
+			U32 page_end = cursor + (U32)(SIMD_PAGE_SIZE - ((Size_t)ptr & (SIMD_PAGE_SIZE - 1))); \
+			while (cursor < page_end) {                                               \
+				if ((CharClassTable[data[cursor]] & char_class) == stop_value) return cursor; \
+				cursor++;                                                             \
+			}                                                                         \
+			continue;                                                                 \
+		}                                                                             \
+		__m128i chunk = _mm_loadu_si128((const __m128i*)ptr);                         \
+		int index = _mm_cmpistri(set, chunk,                                          \
+			_SIDD_UBYTE_OPS | mode | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT); \
+		if (index < 16) return cursor + (U32)index;                                   \
+		cursor += 16;                                                                 \
+	}                                                                                 \
+}
+
+/* set operands are padded to 16 bytes, PCMPISTRI stops reading them at the first NUL */
+static const U8 WhiteSpaceSet[16] = { ' ', '\t', '\r', '\n' };
+static const U8 AlphabetRanges[16] = { 'a', 'z', 'A', 'Z' };
+static const U8 DigitRanges[16] = { '0', '9' };
+
+/* bodies are given as the ranges of everything but their stop bytes, 0x01 up keeps the NUL out of the set */
+static const U8 StringBodyRanges[16] = { 0x01, '\n' - 1, '\n' + 1, '"' - 1, '"' + 1, '\\' - 1, '\\' + 1, 0xFF };
+static const U8 CharBodyRanges[16] = { 0x01, '\n' - 1, '\n' + 1, '\'' - 1, '\'' + 1, '\\' - 1, '\\' + 1, 0xFF };
+static const U8 LineCommentRanges[16] = { 0x01, '\n' - 1, '\n' + 1, 0xFF };
+static const U8 BlockCommentRanges[16] = { 0x01, '*' - 1, '*' + 1, 0xFF };
+
+SSE42_SCAN_RUN(SkipWhiteSpaceSSE42, WhiteSpaceSet, _SIDD_CMP_EQUAL_ANY, CHAR_CLASS_WHITESPACE, 0)
+SSE42_SCAN_RUN(ScanIdentifierSSE42, AlphabetRanges, _SIDD_CMP_RANGES, CHAR_CLASS_ALPHABET, 0)
+SSE42_SCAN_RUN(ScanDigitsSSE42, DigitRanges, _SIDD_CMP_RANGES, CHAR_CLASS_DIGIT, 0)
+SSE42_SCAN_RUN(ScanStringBodySSE42, StringBodyRanges, _SIDD_CMP_RANGES, CHAR_STOP_STRING, CHAR_STOP_STRING)
+SSE42_SCAN_RUN(ScanCharBodySSE42, CharBodyRanges, _SIDD_CMP_RANGES, CHAR_STOP_CHAR, CHAR_STOP_CHAR)
+SSE42_SCAN_RUN(ScanLineCommentSSE42, LineCommentRanges, _SIDD_CMP_RANGES, CHAR_STOP_LINE, CHAR_STOP_LINE)
+SSE42_SCAN_RUN(ScanBlockCommentSSE42, BlockCommentRanges, _SIDD_CMP_RANGES, CHAR_STOP_BLOCK, CHAR_STOP_BLOCK)
+
+/*
+	AVX2: build a 32-bit mask of bytes inside the class and look for the first
+	zero bit. Range checks use the unsigned min trick: x <= n  <=>  min(x, n) == x.
+*/
+#define AVX2_SCAN_RUN(name, char_class, stop_value, in_class_expr)                    \
+SIMD_TARGET_AVX2 SIMD_NO_SANITIZE static U32 name(const U8* data, U32 cursor) {        \
+	for (;;) {                                                                         \
+		const U8* ptr = data + cursor;                                                 \
+		if (!SIMD_LOAD_IS_SAFE(ptr, 32)) {                                             \
+			U32 page_end = cursor + (U32)(SIMD_PAGE_SIZE - ((Size_t)ptr & (SIMD_PAGE_SIZE - 1))); \
+			while (cursor < page_end) {                                                \
+				if ((CharClassTable[data[cursor]] & char_class) == stop_value) return cursor; \
+				cursor++;                                                              \
+			}                                                                          \
+			continue;                                                                  \
+		}                                                                              \
+		__m256i chunk = _mm256_loadu_si256((const __m256i*)ptr);                       \
+		__m256i in_class = in_class_expr;                                              \
+		U32 outside = ~(U32)_mm256_movemask_epi8(in_class);                            \
+		if (outside != 0) return cursor + SIMD_CTZ(outside);                           \
+		cursor += 32;                                                                  \
+	}                                                                                  \
+}
+
+#define AVX2_IN_RANGE(value, low, count) \
+	_mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_sub_epi8(value, _mm256_set1_epi8(low)), \
+		_mm256_set1_epi8((count) - 1)), _mm256_sub_epi8(value, _mm256_set1_epi8(low)))
+
+AVX2_SCAN_RUN(SkipWhiteSpaceAVX2, CHAR_CLASS_WHITESPACE, 0,
+	_mm256_or_si256(
+		_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+		_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')))))
+
+/* folding to lower case with |0x20 keeps every non-letter outside 'a'..'z' */
+AVX2_SCAN_RUN(ScanIdentifierAVX2, CHAR_CLASS_ALPHABET, 0,
+	AVX2_IN_RANGE(_mm256_or_si256(chunk, _mm256_set1_epi8(0x20)), 'a', 26))
+
+AVX2_SCAN_RUN(ScanDigitsAVX2, CHAR_CLASS_DIGIT, 0,
+	AVX2_IN_RANGE(chunk, '0', 10))
+
+/* bodies run until one of their stop bytes, the NUL terminator is always one of them */
+#define AVX2_EQUAL(value, c) _mm256_cmpeq_epi8(value, _mm256_set1_epi8(c))
+#define AVX2_NONE(mask) _mm256_cmpeq_epi8(mask, _mm256_setzero_si256())
+
+AVX2_SCAN_RUN(ScanStringBodyAVX2, CHAR_STOP_STRING, CHAR_STOP_STRING,
+	AVX2_NONE(_mm256_or_si256(
+		_mm256_or_si256(AVX2_EQUAL(chunk, '"'), AVX2_EQUAL(chunk, '\\')),
+		_mm256_or_si256(AVX2_EQUAL(chunk, '\n'), AVX2_EQUAL(chunk, '\0')))))
+
+AVX2_SCAN_RUN(ScanCharBodyAVX2, CHAR_STOP_CHAR, CHAR_STOP_CHAR,
+	AVX2_NONE(_mm256_or_si256(
+		_mm256_or_si256(AVX2_EQUAL(chunk, '\''), AVX2_EQUAL(chunk, '\\')),
+		_mm256_or_si256(AVX2_EQUAL(chunk, '\n'), AVX2_EQUAL(chunk, '\0')))))
+
+AVX2_SCAN_RUN(ScanLineCommentAVX2, CHAR_STOP_LINE, CHAR_STOP_LINE,
+	AVX2_NONE(_mm256_or_si256(AVX2_EQUAL(chunk, '\n'), AVX2_EQUAL(chunk, '\0'))))
+
+AVX2_SCAN_RUN(ScanBlockCommentAVX2, CHAR_STOP_BLOCK, CHAR_STOP_BLOCK,
+	AVX2_NONE(_mm256_or_si256(AVX2_EQUAL(chunk, '*'), AVX2_EQUAL(chunk, '\0'))))
+
+#endif
+
+void ScannerKernelsInit(const CPUInfo* info) {
+#ifdef SIMD_X86
+	if (info->has_avx2) {
+		g_scannerKernels = (ScannerKernels) {
+			.skip_whitespace = SkipWhiteSpaceAVX2,
+			.scan_identifier = ScanIdentifierAVX2,
+			.scan_digits = ScanDigitsAVX2,
+			.scan_string_body = ScanStringBodyAVX2,
+			.scan_char_body = ScanCharBodyAVX2,
+			.scan_line_comment = ScanLineCommentAVX2,
+			.scan_block_comment = ScanBlockCommentAVX2,
+			.name = (const U8*)"avx2",
+		};
+		return;
+	}
+
+	if (info->has_sse42) {
+		g_scannerKernels = (ScannerKernels) {
+			.skip_whitespace = SkipWhiteSpaceSSE42,
+			.scan_identifier = ScanIdentifierSSE42,
+			.scan_digits = ScanDigitsSSE42,
+			.scan_string_body = ScanStringBodySSE42,
+			.scan_char_body = ScanCharBodySSE42,
+			.scan_line_comment = ScanLineCommentSSE42,
+			.scan_block_comment = ScanBlockCommentSSE42,
+			.name = (const U8*)"sse4.2",
+		};
+		return;
+	}
+#endif
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Common.h"
+#include "CPU.h"
+
+/*
+	Run scanners used by the scanner's hot loop. Each one returns the offset of
+	the first byte at or after cursor that doesn't belong to its character class.
+	None of the classes contain '\0', so a run always stops at the terminator.
+*/
+typedef U32 (*ScanRunFn)(const U8* data, U32 cursor);
+
+typedef struct scannerkernels_t {
+	ScanRunFn skip_whitespace;     // ' ', '\t', '\r', '\n'
+	ScanRunFn scan_identifier;     // [a-zA-Z]
+	ScanRunFn scan_digits;         // [0-9]
+	ScanRunFn scan_string_body;    // anything but '"', '\\', '\n'
+	ScanRunFn scan_char_body;      // anything but '\'', '\\', '\n'
+	ScanRunFn scan_line_comment;   // anything but '\n'
+	ScanRunFn scan_block_comment;  // anything but '*'
+	const U8* name;
+} ScannerKernels;
+
+extern ScannerKernels g_scannerKernels;
+
+/* Picks the widest kernel set the CPU supports, until then the scalar set is used */
+void ScannerKernelsInit(const CPUInfo* info);
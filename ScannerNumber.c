@@ -0,0 +1,255 @@
+#include "ScannerNumber.h"
+#include "Scanner.h"
+#include "ScannerKernels.h"
+#include "Memory.h"
+
+#include <stdlib.h>
+#include <math.h>
+
+#define NUMBER_MAX_SIGNIFICANT 19       // decimal digits that always fit in a U64
+#define NUMBER_MAX_EXPONENT 100000      // larger exponents are clamped, the result is 0 or out of range either way
+#define NUMBER_FAST_PATH_MANTISSA (1ULL << 53)
+#define NUMBER_FAST_PATH_EXPONENT 22
+#define NUMBER_COPY_SIZE 128
+
+/* Digit value + 1, 0 for bytes that aren't digits in any base */
+static const U8 DigitValueTable[256] = {
+	['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+	['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+	['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+	['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
+/* Powers of ten a double holds exactly, the float fast path multiplies or divides by one of them */
+static const double ExactPowersOfTen[NUMBER_FAST_PATH_EXPONENT + 1] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static Bool IsDigit(U8 c) {
+	return c >= '0' && c <= '9';
+}
+
+/* Non-digits wrap around to 0xFFFFFFFF, past the limit of every base */
+static U32 DigitValue(U8 c) {
+	return (U32)DigitValueTable[c] - 1;
+}
+
+/* A misplaced '_' spoils the whole literal, the rest of its digits and separators go with it */
+static U32 SkipMalformedTail(const U8* data, U32 cursor) {
+	while (data[cursor] == '_' || DigitValue(data[cursor]) < 16) cursor++;
+	return cursor;
+}
+
+static Token NumberToken(TokenKind kind, U32 start, U32 end, U32 value) {
+	return (Token) {.kind= kind, .start= start, .length= end - start, .value= value};
+}
+
+/* Assembled byte by byte so the first digit is the lowest byte on any host, compilers fold it into one load */
+static U64 SwarLoad(const U8* ptr) {
+	return (U64)ptr[0] | ((U64)ptr[1] << 8) | ((U64)ptr[2] << 16) | ((U64)ptr[3] << 24) |
+		((U64)ptr[4] << 32) | ((U64)ptr[5] << 40) | ((U64)ptr[6] << 48) | ((U64)ptr[7] << 56);
+}
+
+/*
+	Eight ASCII digits to their value in three multiplies: neighbouring digits
+	are combined into pairs, pairs into quads, quads into the result.
+*/
+static U32 SwarParseEightDigits(U64 chunk) {
+	chunk -= 0x3030303030303030ULL;
+	chunk = (chunk * 10) + (chunk >> 8);
+	chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+		(((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+	return (U32)chunk;
+}
+
+/* Folds the digits in [cursor, end) into value, FALSE if it no longer fits in 64 bits */
+static Bool AccumulateDecimal(const U8* data, U32 cursor, U32 end, U64* value) {
+	U64 result = *value;
+	while (end - cursor >= 8) {
+		U64 eight = SwarParseEightDigits(SwarLoad(data + cursor));
+		if (result > ((U64)-1 - eight) / 100000000) return FALSE;
+		result = result * 100000000 + eight;
+		cursor += 8;
+	}
+	while (cursor < end) {
+		U64 digit = data[cursor] - '0';
+		if (result > ((U64)-1 - digit) / 10) return FALSE;
+		result = result * 10 + digit;
+		cursor++;
+	}
+	*value = result;
+	return TRUE;
+}
+
+static Token FinishInteger(U32 start, U32 end, U64 value, Bool overflow, Bool malformed, Interner* interner) {
+	if (malformed) return NumberToken(TOKEN_ILLEGAL, start, end, SCANNER_ERROR_NUMBER_MALFORMED);
+	if (overflow) return NumberToken(TOKEN_ILLEGAL, start, end, SCANNER_ERROR_NUMBER_OVERFLOW);
+	return NumberToken(TOKEN_NUMERIC, start, end, Interner_AddConstant(interner, value));
+}
+
+/*
+	0x and 0b literals, shift is the bits per digit. Binary literals take in
+	every decimal digit so "0b102" is reported instead of splitting into two tokens.
+*/
+static Token ScanRadix(const U8* data, U32 start, U32 shift, Interner* interner) {
+	U32 limit = shift == 4 ? 16 : 10;
+	U32 cursor = start + 2;
+	U64 value = 0;
+	Bool overflow = FALSE;
+	Bool malformed = FALSE;
+
+	for (;; cursor++) {
+		if (data[cursor] == '_') {
+			if (DigitValue(data[cursor + 1]) >= limit) {
+				malformed = TRUE;
+				cursor = SkipMalformedTail(data, cursor);
+				break;
+			}
+			continue;
+		}
+
+		U32 digit = DigitValue(data[cursor]);
+		if (digit >= limit) break;
+		if ((digit >> shift) != 0) malformed = TRUE;
+		if ((value >> (64 - shift)) != 0) overflow = TRUE;
+		value = (value << shift) | digit;
+	}
+	return FinishInteger(start, cursor, value, overflow, malformed, interner);
+}
+
+/* An exponent starts at cursor: e or E, an optional sign, then a digit */
+static Bool IsExponent(const U8* data, U32 cursor) {
+	if (data[cursor] != 'e' && data[cursor] != 'E') return FALSE;
+	if (data[cursor + 1] == '+' || data[cursor + 1] == '-') return IsDigit(data[cursor + 2]);
+	return IsDigit(data[cursor + 1]);
+}
+
+/* Slow path, strtod on a copy with the separators taken out */
+static double ParseFloatSlow(const U8* data, U32 start, U32 end) {
+	char buffer[NUMBER_COPY_SIZE];
+	char* copy = end - start < NUMBER_COPY_SIZE ? buffer : Malloc(end - start + 1);
+	if (copy == NULL) {
+		PANIC("Malloc Failed");
+	}
+
+	U32 length = 0;
+	for (U32 i = start; i < end; i++) {
+		if (data[i] != '_') copy[length++] = (char)data[i];
+	}
+	copy[length] = '\0';
+
+	double result = strtod(copy, NULL);
+	if (copy != buffer) Free(copy);
+	return result;
+}
+
+/*
+	Up to 19 significant digits are collected into an integer mantissa. When it
+	is at most 2^53 and the decimal exponent within +-22, both the mantissa and
+	the power of ten are exact doubles and one correctly rounded multiply or
+	divide gives the exact result (Clinger's fast path). Anything else goes
+	through strtod.
+*/
+static Token ScanFloat(const U8* data, U32 start, Interner* interner) {
+	U64 mantissa = 0;
+	S32 exponent = 0;
+	U32 significant = 0;
+	Bool truncated = FALSE;
+	Bool seen_dot = FALSE;
+	Bool malformed = FALSE;
+
+	U32 cursor = start;
+	for (;; cursor++) {
+		U8 c = data[cursor];
+		if (c == '_') {
+			if (!IsDigit(data[cursor + 1])) {
+				malformed = TRUE;
+				cursor = SkipMalformedTail(data, cursor);
+				break;
+			}
+			continue;
+		}
+		if (c == '.' && !seen_dot && IsDigit(data[cursor + 1])) {
+			seen_dot = TRUE;
+			continue;
+		}
+		if (!IsDigit(c)) break;
+
+		/* leading zeros aren't significant */
+		if (mantissa == 0 && c == '0') {
+			if (seen_dot) exponent--;
+			continue;
+		}
+		if (significant < NUMBER_MAX_SIGNIFICANT) {
+			mantissa = mantissa * 10 + (c - '0');
+			significant++;
+			if (seen_dot) exponent--;
+		}
+		else {
+			if (c != '0') truncated = TRUE;
+			if (!seen_dot) exponent++;
+		}
+	}
+
+	if (!malformed && IsExponent(data, cursor)) {
+		cursor++;
+		Bool negative = data[cursor] == '-';
+		if (data[cursor] == '+' || data[cursor] == '-') cursor++;
+
+		S32 written = 0;
+		for (; IsDigit(data[cursor]) || (data[cursor] == '_' && IsDigit(data[cursor + 1])); cursor++) {
+			if (data[cursor] == '_') continue;
+			if (written < NUMBER_MAX_EXPONENT) written = written * 10 + (data[cursor] - '0');
+		}
+		exponent += negative ? -written : written;
+	}
+
+	if (malformed) return NumberToken(TOKEN_ILLEGAL, start, cursor, SCANNER_ERROR_NUMBER_MALFORMED);
+
+	double result;
+	if (!truncated && mantissa <= NUMBER_FAST_PATH_MANTISSA &&
+		exponent >= -NUMBER_FAST_PATH_EXPONENT && exponent <= NUMBER_FAST_PATH_EXPONENT) {
+		result = exponent >= 0 ? (double)mantissa * ExactPowersOfTen[exponent] : (double)mantissa / ExactPowersOfTen[-exponent];
+	}
+	else {
+		result = ParseFloatSlow(data, start, cursor);
+		if (result == HUGE_VAL) return NumberToken(TOKEN_ILLEGAL, start, cursor, SCANNER_ERROR_NUMBER_OVERFLOW);
+	}
+
+	U64 bits;
+	Memcpy(&bits, &result, sizeof(bits));
+	return NumberToken(TOKEN_FLOAT, start, cursor, Interner_AddConstant(interner, bits));
+}
+
+Token ScannerScanNumber(const U8* data, U32 start, Interner* interner) {
+	if (data[start] == '0') {
+		U8 prefix = data[start + 1];
+		if ((prefix == 'x' || prefix == 'X') && DigitValue(data[start + 2]) < 16) return ScanRadix(data, start, 4, interner);
+		if ((prefix == 'b' || prefix == 'B') && DigitValue(data[start + 2]) < 2) return ScanRadix(data, start, 1, interner);
+	}
+
+	/* digit runs are found by the run kernel and converted eight at a time */
+	U32 cursor = start;
+	U64 value = 0;
+	Bool overflow = FALSE;
+	Bool malformed = FALSE;
+	for (;;) {
+		U32 end = g_scannerKernels.scan_digits(data, cursor);
+		if (!overflow && !AccumulateDecimal(data, cursor, end, &value)) overflow = TRUE;
+		cursor = end;
+
+		if (data[cursor] != '_') break;
+		if (!IsDigit(data[cursor + 1])) {
+			malformed = TRUE;
+			cursor = SkipMalformedTail(data, cursor);
+			break;
+		}
+		cursor++;
+	}
+
+	if (!malformed && ((data[cursor] == '.' && IsDigit(data[cursor + 1])) || IsExponent(data, cursor))) {
+		return ScanFloat(data, start, interner);
+	}
+	return FinishInteger(start, cursor, value, overflow, malformed, interner);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "Common.h"
+#include "Token.h"
+#include "Intern.h"
+
+/*
+	Number literals, decoded while they are scanned:
+		decimal   123, 1_000_000
+		hex       0xFF, 0xdead_beef
+		binary    0b1010_0101
+		float     1.5, 2e10, 6.022_140e-23
+	'_' may only sit between two digits. A prefix only counts as one when a
+	digit of its base follows it, "0bar" is still 0 followed by an identifier.
+
+	Integers must fit in 64 bits, floats are doubles. The decoded value (the
+	double's bits for floats) goes into the interner's constant table and the
+	token's value is its index there. A literal that overflows or is malformed
+	comes back as TOKEN_ILLEGAL carrying the ScannerError.
+*/
+Token ScannerScanNumber(const U8* data, U32 start, Interner* interner);
@@ -0,0 +1,189 @@
+#include "Scanner.h"
+#include "ScannerKernels.h"
+#include "Memory.h"
+#include "Logger.h"
+#include "Profile.h"
+
+#define SCANNER_PARALLEL_MIN_CHUNK      (64 * 1024)
+#define SCANNER_BOUNDARY_SEARCH_WINDOW  (64 * 1024)
+#define SCANNER_UNMAPPED_SYMBOL         0xFFFFFFFF
+
+typedef struct scannerchunk_t {
+	StrView source;
+	U32 begin;
+	U32 end;
+	TokenBuffer* tokens;
+	Interner* interner;         // chunk-local ids, remapped to the shared interner while stitching
+	Arena* arena;
+} ScannerChunk;
+
+static Bool IsWhiteSpace(U8 c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/*
+	Speculative pass: a newline is the likeliest spot outside of any token, any
+	other whitespace is the next best. Returns 0 if the window has neither.
+	Nothing here proves the spot is safe, the stitcher validates every boundary.
+*/
+static U32 FindChunkBoundary(const U8* data, U32 size, U32 target) {
+	U32 limit = size - target > SCANNER_BOUNDARY_SEARCH_WINDOW ? target + SCANNER_BOUNDARY_SEARCH_WINDOW : size;
+
+	for (U32 i = target; i < limit; i++) {
+		if (data[i] == '\n') return i;
+	}
+	for (U32 i = target; i < limit; i++) {
+		if (IsWhiteSpace(data[i])) return i;
+	}
+	return 0;
+}
+
+static void ScanChunkJob(void* arg, U32 worker_index) {
+	(void)worker_index;
+	ScannerChunk* chunk = arg;
+	/* the pool thread may be in the middle of another job's allocations, its tag is put back after */
+	const char* saved_tag = MALLOC_TAG_CURRENT();
+	MALLOC_TAG("scan_chunk");
+	ProfileScope scope = Profile_Begin("scan_chunk", NULL);
+
+	U32 length = chunk->end == SCANNER_NO_END ? SCANNER_PARALLEL_MIN_CHUNK : chunk->end - chunk->begin;
+	chunk->arena = Arena_Create(ARENA_DEFAULT_BLOCK_SIZE);
+	chunk->interner = Interner_Create(chunk->arena, 256);
+	chunk->tokens = TokenBuffer_Create(TokenBuffer_EstimateCapacity(length), chunk->source.ptr);
+
+	ScannerInfo sInfo = ScannerInit(chunk->source, chunk->tokens, chunk->interner);
+	sInfo.cursor = chunk->begin;
+	sInfo.end = chunk->end;
+	ScannerTokenizeRange(&sInfo);
+	Profile_End(&scope);
+	MALLOC_TAG(saved_tag);
+}
+
+/* Appends chunk tokens [first, count) and translates their chunk-local symbols */
+static void AppendChunkTokens(ScannerChunk* chunk, U32 first, TokenBuffer* tokens, Interner* interner, U32* symbol_map) {
+	TokenBuffer* local = chunk->tokens;
+	for (U32 i = first; i < local->count; i++) {
+		Token token = TokenBuffer_Get(local, i);
+		if (token.kind == TOKEN_IDENTIFIER) {
+			/* first use in stream order assigns the global id, matching a serial scan */
+			if (symbol_map[token.value] == SCANNER_UNMAPPED_SYMBOL) {
+				symbol_map[token.value] = Interner_Intern(interner, StrView_Slice(chunk->source, token.start, token.length));
+			}
+			token.value = symbol_map[token.value];
+		}
+		else if (token.kind == TOKEN_NUMERIC || token.kind == TOKEN_FLOAT) {
+			/* constants are numbered in stream order as well */
+			token.value = Interner_AddConstant(interner, Interner_GetConstant(chunk->interner, token.value));
+		}
+		TokenBuffer_Push(tokens, token);
+	}
+}
+
+/*
+	Walks the chunks in order keeping resume, the end of the last token emitted.
+	The scanner carries no state between tokens, so once a serial scan from
+	resume lands on a token start the chunk also produced, the chunk's stream
+	from there on is exactly the serial one. Until that happens (the previous
+	chunk's last token ran over the boundary) tokens are rescanned serially.
+	Returns TRUE once the EOF token has been emitted.
+*/
+static Bool StitchChunks(ScannerChunk* chunks, U32 chunk_count, StrView source, TokenBuffer* tokens, Interner* interner, U32* resume) {
+	ScannerInfo serial = ScannerInit(source, tokens, interner);
+
+	for (U32 k = 0; k < chunk_count; k++) {
+		TokenBuffer* local = chunks[k].tokens;
+		U32 index = 0;
+
+		U32* symbol_map = Malloc((chunks[k].interner->entries.count + 1) * sizeof(*symbol_map));
+		if (symbol_map == NULL) {
+			PANIC("Malloc Failed");
+		}
+		for (U32 i = 0; i < chunks[k].interner->entries.count; i++) symbol_map[i] = SCANNER_UNMAPPED_SYMBOL;
+
+		for (;;) {
+			U32 position = ScannerSkipTrivia(source.ptr, *resume);
+			while (index < local->count && local->start[index] < position) index++;
+			if (index == local->count) break;
+
+			if (local->start[index] == position) {
+				AppendChunkTokens(&chunks[k], index, tokens, interner, symbol_map);
+				U32 last = local->count - 1;
+				*resume = local->start[last] + local->length[last];
+				if (local->kind[last] == TOKEN_EOF) {
+					Free(symbol_map);
+					return TRUE;
+				}
+				break;
+			}
+
+			serial.cursor = *resume;
+			Token token = ScannerScanToken(&serial);
+			TokenBuffer_Push(tokens, token);
+			if (token.kind == TOKEN_EOF) {
+				Free(symbol_map);
+				return TRUE;
+			}
+			*resume = token.start + token.length;
+		}
+
+		Free(symbol_map);
+	}
+
+	return FALSE;
+}
+
+void ScannerTokenizeParallel(StrView source, TokenBuffer* tokens, Interner* interner,
+	ThreadPool* pool, U32 chunk_count) {
+	if (source.ptr == NULL) return;
+
+	U32 max_chunks = source.len / SCANNER_PARALLEL_MIN_CHUNK;
+	if (chunk_count > max_chunks) chunk_count = max_chunks;
+	if (chunk_count < 2) {
+		ScannerTokenize(source, tokens, interner);
+		return;
+	}
+
+	ScannerChunk* chunks = Malloc(chunk_count * sizeof(*chunks));
+	if (chunks == NULL) {
+		PANIC("Malloc Failed");
+	}
+
+	U32 used = 0;
+	U32 begin = 0;
+	for (U32 k = 1; k < chunk_count; k++) {
+		U32 target = (U32)(((U64)source.len * k) / chunk_count);
+		if (target <= begin) continue;
+
+		U32 boundary = FindChunkBoundary(source.ptr, source.len, target);
+		if (boundary <= begin) continue;
+
+		chunks[used++] = (ScannerChunk) {.source= source, .begin= begin, .end= boundary};
+		begin = boundary;
+	}
+	/* the last chunk runs to the terminator and produces EOF */
+	chunks[used++] = (ScannerChunk) {.source= source, .begin= begin, .end= SCANNER_NO_END};
+
+	JobGroup group = {0};
+	for (U32 k = 0; k < used; k++) {
+		ThreadPool_Submit(pool, &group, ScanChunkJob, &chunks[k]);
+	}
+	ThreadPool_Wait(pool, &group);
+	MALLOC_TAG("scan_stitch");
+
+	ProfileScope stitch_scope = Profile_Begin("scan_stitch", NULL);
+	U32 resume = 0;
+	if (!StitchChunks(chunks, used, source, tokens, interner, &resume)) {
+		/* can't normally happen, the last chunk always ends in EOF, but finish serially to be safe */
+		ScannerInfo sInfo = ScannerInit(source, tokens, interner);
+		sInfo.cursor = resume;
+		ScannerTokenizeRange(&sInfo);
+	}
+	Profile_End(&stitch_scope);
+
+	for (U32 k = 0; k < used; k++) {
+		TokenBuffer_Free(chunks[k].tokens);
+		Interner_Destroy(chunks[k].interner);
+		Arena_Destroy(chunks[k].arena);
+	}
+	Free(chunks);
+}
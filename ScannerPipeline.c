@@ -0,0 +1,141 @@
+#include "Scanner.h"
+#include "Memory.h"
+#include "Thread.h"
+#include "Atomic.h"
+#include "Profile.h"
+
+#define SCANNER_PIPE_RING_MASK   (SCANNER_PIPE_RING_SIZE - 1)
+#define SCANNER_PIPE_SPIN_LIMIT  256
+
+typedef struct tokenbatch_t {
+	U32 count;
+	Token tokens[SCANNER_PIPE_BATCH_SIZE];
+} TokenBatch;
+
+/*
+	published and released count batches and only ever grow, the slot of batch
+	n is n & SCANNER_PIPE_RING_MASK. Each side keeps a cached copy of the other
+	side's counter and only reloads it when the cached value says it must wait,
+	so in the steady state neither side touches the other's cache line.
+*/
+struct scannerpipe_t {
+	AtomicPaddedU32 published;  // batches filled, advanced by the scanner thread
+	AtomicPaddedU32 released;   // batches handed back, advanced by the consumer
+	volatile U32 cancelled;     // set by ScannerPipe_Finish, unblocks a stalled scanner
+
+	/* scanner thread only */
+	ScannerInfo scanner;
+	U32 cached_released;
+	U8 scanner_padding[ATOMIC_CACHE_LINE_SIZE];
+
+	/* consumer only */
+	U32 cached_published;
+	U32 read_batch;             // batch being read, every batch before it has been released
+	U32 read_index;             // next token in that batch
+
+	TokenBatch* batches;
+	Thread* thread;
+};
+
+/* Spins briefly and then gives the core away, the other side is usually only a batch behind */
+static void PipeBackOff(U32* spins) {
+	if (*spins < SCANNER_PIPE_SPIN_LIMIT) {
+		Atomic_Pause();
+		(*spins)++;
+	}
+	else {
+		Thread_Yield();
+	}
+}
+
+static void ScannerPipeMain(void* arg) {
+	ScannerPipe* pipe = arg;
+	Profile_SetThreadName("scanner", PROFILE_NO_INDEX);
+	ProfileScope scope = Profile_Begin("scan_pipeline", NULL);
+
+	for (U32 position = 0;; position++) {
+		/* back-pressure, wait for the consumer to hand a batch back */
+		U32 spins = 0;
+		while (position - pipe->cached_released == SCANNER_PIPE_RING_SIZE) {
+			if (Atomic_LoadU32(&pipe->cancelled)) {
+				Profile_End(&scope);
+				return;
+			}
+			pipe->cached_released = Atomic_LoadU32(&pipe->released.value);
+			if (position - pipe->cached_released == SCANNER_PIPE_RING_SIZE) PipeBackOff(&spins);
+		}
+
+		TokenBatch* batch = &pipe->batches[position & SCANNER_PIPE_RING_MASK];
+		Bool finished = FALSE;
+		U32 count = 0;
+		while (count < SCANNER_PIPE_BATCH_SIZE && !finished) {
+			Token token = ScannerScanToken(&pipe->scanner);
+			batch->tokens[count++] = token;
+			finished = token.kind == TOKEN_EOF;
+		}
+		batch->count = count;
+
+		Atomic_StoreU32(&pipe->published.value, position + 1);
+		if (finished) break;
+	}
+
+	Profile_End(&scope);
+}
+
+ScannerPipe* ScannerPipe_Start(StrView source, Interner* interner) {
+	ScannerPipe* pipe = Malloc(sizeof(*pipe));
+	TokenBatch* batches = Malloc(SCANNER_PIPE_RING_SIZE * sizeof(*batches));
+	if (pipe == NULL || batches == NULL) {
+		Free(pipe);
+		Free(batches);
+		return NULL;
+	}
+
+	pipe->published.value = 0;
+	pipe->released.value = 0;
+	pipe->cancelled = 0;
+	pipe->scanner = ScannerInit(source, NULL, interner);
+	pipe->cached_released = 0;
+	pipe->cached_published = 0;
+	pipe->read_batch = 0;
+	pipe->read_index = 0;
+	pipe->batches = batches;
+
+	pipe->thread = Thread_Create(ScannerPipeMain, pipe);
+	if (pipe->thread == NULL) {
+		Free(batches);
+		Free(pipe);
+		return NULL;
+	}
+	return pipe;
+}
+
+Token ScannerPipe_Next(ScannerPipe* pipe) {
+	U32 spins = 0;
+	while (pipe->read_batch == pipe->cached_published) {
+		pipe->cached_published = Atomic_LoadU32(&pipe->published.value);
+		if (pipe->read_batch == pipe->cached_published) PipeBackOff(&spins);
+	}
+
+	TokenBatch* batch = &pipe->batches[pipe->read_batch & SCANNER_PIPE_RING_MASK];
+	Token token = batch->tokens[pipe->read_index];
+	/* EOF ends the last batch, leave the index on it so it repeats */
+	if (token.kind == TOKEN_EOF) return token;
+
+	pipe->read_index++;
+	if (pipe->read_index == batch->count) {
+		pipe->read_index = 0;
+		pipe->read_batch++;
+		Atomic_StoreU32(&pipe->released.value, pipe->read_batch);
+	}
+	return token;
+}
+
+void ScannerPipe_Finish(ScannerPipe* pipe) {
+	if (pipe == NULL) return;
+
+	Atomic_StoreU32(&pipe->cancelled, 1);
+	Thread_Join(pipe->thread);
+	Free(pipe->batches);
+	Free(pipe);
+}
@@ -0,0 +1,92 @@
+#include "Scanner.h"
+#include "Profile.h"
+
+/* The furthest past its end a token's scan reads: "1e+5" is tried as an exponent from the "1" */
+#define SCANNER_RELEX_LOOKAHEAD 3
+
+/*
+	Index of the first token whose scan may have read a byte at or after offset.
+	Token ends only grow along the stream, so it's a binary search.
+*/
+static U32 FindRestartToken(const TokenBuffer* tokens, U32 offset) {
+	U32 low = 0;
+	U32 high = tokens->count;
+	while (low < high) {
+		U32 middle = low + (high - low) / 2;
+		U64 end = (U64)TokenBuffer_GetStart(tokens, middle) + tokens->length[TokenBuffer_Slot(tokens, middle)];
+		if (end + SCANNER_RELEX_LOOKAHEAD <= offset) low = middle + 1;
+		else high = middle;
+	}
+	return low;
+}
+
+/* Start of the first token after the gap, in the old source */
+static inline U32 TailStart(const TokenBuffer* tokens) {
+	return tokens->start[tokens->capacity - tokens->tail] + tokens->tail_shift;
+}
+
+/* Puts a fresh token at the end of the head, the gap grows when it runs out */
+static inline void InsertAtGap(TokenBuffer* tokens, Token token) {
+	if (tokens->count == tokens->capacity) {
+		TokenBuffer_Grow(tokens);
+	}
+
+	U32 slot = tokens->count - tokens->tail;
+	tokens->kind[slot] = (U8)token.kind;
+	tokens->start[slot] = token.start;
+	tokens->length[slot] = token.length;
+	tokens->value[slot] = token.value;
+	tokens->count++;
+}
+
+/*
+	Bytes before edit.offset are unchanged and the scanner carries no state
+	between tokens, so every token that ends far enough before the edit stays and
+	scanning resumes at the end of the last of them. Past the edit the bytes are
+	the old ones shifted by delta: as soon as a new token starts where a shifted
+	old token started, both streams continue identically (the same argument the
+	parallel stitcher relies on) and the rest of the old stream is reused.
+
+	The gap is moved to the restart token, stale tokens are dropped off the
+	front of the tail and fresh ones are written behind the head. The tail
+	itself is never touched, delta goes into its pending shift.
+*/
+ScannerRelexResult ScannerRelex(TokenBuffer* tokens, Interner* interner, StrView source, ScannerEdit edit) {
+	ProfileScope scope = Profile_Begin("scan_relex", NULL);
+	tokens->source = source.ptr;
+
+	U32 first = FindRestartToken(tokens, edit.offset);
+	U32 resume = first == 0 ? 0 : TokenBuffer_GetStart(tokens, first - 1) + tokens->length[TokenBuffer_Slot(tokens, first - 1)];
+	U32 delta = edit.inserted - edit.removed;
+	U32 edit_end = edit.offset + edit.inserted;
+	TokenBuffer_MoveGap(tokens, first);
+
+	ScannerInfo sInfo = ScannerInit(source, NULL, interner);
+	sInfo.cursor = resume;
+	ScannerRelexResult result = {.first= first, .removed= 0, .inserted= 0};
+	for (;;) {
+		Token token = ScannerScanToken(&sInfo);
+		if (token.start >= edit_end) {
+			U32 old_start = token.start - delta;
+			while (tokens->tail != 0 && TailStart(tokens) < old_start) {
+				tokens->tail--;
+				tokens->count--;
+				result.removed++;
+			}
+			if (tokens->tail != 0 && TailStart(tokens) == old_start) break;
+		}
+
+		if (token.kind == TOKEN_EOF) {
+			tokens->count -= tokens->tail;
+			result.removed += tokens->tail;
+			tokens->tail = 0;
+		}
+		InsertAtGap(tokens, token);
+		result.inserted++;
+		if (token.kind == TOKEN_EOF) break;
+	}
+
+	tokens->tail_shift = tokens->tail != 0 ? tokens->tail_shift + delta : 0;
+	Profile_End(&scope);
+	return result;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Token.h"
+
+/*
+	Every fixed-spelling token besides the keywords (those are KEYWORD_LIST in
+	Keyword.h), X(kind, spelling). Tools/LexGen.c compiles both lists into the
+	tables of ScannerTables.h, the switch in Scanner.c is kept in step by hand.
+	A spelling may extend another one ("<" and "<="), the longest match wins.
+	String and char literals and comments have bodies, not spellings, both
+	scanners handle them before looking at this list.
+*/
+#define SCANNER_OPERATOR_LIST(X)          \
+	X(TOKEN_LEFT_PAREN,    "(")           \
+	X(TOKEN_RIGHT_PAREN,   ")")           \
+	X(TOKEN_LEFT_BRACE,    "{")           \
+	X(TOKEN_RIGHT_BRACE,   "}")           \
+	X(TOKEN_MUL,           "*")           \
+	X(TOKEN_DIV,           "/")           \
+	X(TOKEN_PLUS,          "+")           \
+	X(TOKEN_MINUS,         "-")           \
+	X(TOKEN_SEMICOLON,     ";")           \
+	X(TOKEN_COLON,         ":")           \
+	X(TOKEN_COMMA,         ",")           \
+	X(TOKEN_LESS_THAN,     "<")           \
+	X(TOKEN_GREATER_THAN,  ">")           \
+	X(TOKEN_EQUAL,         "=")           \
+	X(TOKEN_AT,            "@")           \
+	X(TOKEN_EQUAL_EQUAL,   "==")          \
+	X(TOKEN_BANG_EQUAL,    "!=")          \
+	X(TOKEN_LESS_EQUAL,    "<=")          \
+	X(TOKEN_GREATER_EQUAL, ">=")          \
+	X(TOKEN_ARROW,         "->")
@@ -0,0 +1,47 @@
+#pragma once
+#include "Common.h"
+
+/*
+	Shared helpers for code that carries hand-written SIMD paths.
+	Kernels are compiled for their instruction set with SIMD_TARGET_* and are
+	only ever called after CPUInfo reported support, so the rest of the
+	program keeps building for the baseline target.
+*/
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define SIMD_TARGET_AVX2  __attribute__((target("avx2")))
+#define SIMD_CTZ(x) ((U32)__builtin_ctz(x))
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define SIMD_TARGET_SSE42
+#define SIMD_TARGET_AVX2
+static __inline U32 SimdCtz(U32 x) {
+	unsigned long index;
+	_BitScanForward(&index, x);
+	return (U32)index;
+}
+#define SIMD_CTZ(x) SimdCtz(x)
+#endif
+
+/*
+	Kernels that read whole aligned vectors around a string's bytes can't fault
+	(an aligned load never crosses a page) but do touch bytes outside the
+	object, which AddressSanitizer would report.
+*/
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8)
+#define SIMD_NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+#define SIMD_NO_SANITIZE
+#endif
+
+#define SIMD_PAGE_SIZE 4096
+
+/* True when a width-byte load at ptr stays inside one page, so it can't fault past a terminator */
+#define SIMD_LOAD_IS_SAFE(ptr, width) \
+	((((Size_t)(ptr)) & (SIMD_PAGE_SIZE - 1)) <= (SIMD_PAGE_SIZE - (width)))
@@ -1,46 +1,68 @@
 #include "String.h"
-#include "Memory.h"
+#include "StringKernels.h"
 
 U32 GetStringLength(const char* str) {
 	if (str == NULL) return 0;
-	U32 length = 0;
+	return g_stringKernels.length(str);
+}
 
-	for (;*str; str++, length++);
+static S8 CompareResult(S32 difference) {
+	if (difference > 0) return 1;
+	if (difference < 0) return -1;
+	return 0;
+}
 
-	return length;
+S8 StringCompare(const U8* first, const U8* second) {
+	if (first == NULL) return -1;
+	if (second == NULL) return 1;
+
+	/* stops at the first differing byte or the terminator, neither string is measured */
+	return CompareResult(g_stringKernels.compare(first, second));
 }
 
-static S8 SafeStringCompare(const U8* first, const U8* second, U32 first_length, U32 second_length) {
-	
+S8 StringCompareLength(const U8* first, U32 first_length, const U8* second, U32 second_length) {
 	U32 min_length = first_length > second_length ? second_length : first_length;
-	/*
-		look for the first unmatching character and return :
-		 1  - if the ascii value of first greater than the ascii value of second
-		-1  - if the ascii value of second greater than the ascii value of first
-		 0  - if it never got to a distinguisehd character 
-	*/
-	for (int i = 0; i < min_length; i++) {
-		if (first[i] - second[i] > 0) return 1;
-		if (first[i] - second[i] < 0) return -1;
-	}
-
-	/* if we got here meaning one of the strings is a substring */
-	if (first_length > second_length) return 1; // if the second string is a substring of the first
-	if (first_length < second_length) return -1;  // if the first string is a substring of the second
 
+	S8 result = CompareResult(g_stringKernels.compare_bytes(first, second, min_length));
+	if (result != 0) return result;
 
-	/* if we got here the two strings are identical */
+	/* if we got here one of the strings is a prefix of the other, or they're identical */
+	if (first_length > second_length) return 1;
+	if (first_length < second_length) return -1;
 	return 0;
 }
 
-S8 StringCompare(const U8* first, const U8* second) {
-	if (first == NULL) return -1;
-	if (second == NULL) return 1;
+Bool StringEqualLength(const U8* first, U32 first_length, const U8* second, U32 second_length) {
+	if (first_length != second_length) return FALSE;
+	return g_stringKernels.compare_bytes(first, second, first_length) == 0;
+}
+
+const U8* StringFindByte(const U8* data, U8 byte, Size_t length) {
+	return g_stringKernels.find_byte(data, byte, length);
+}
 
-	U32 first_length   = GetStringLength(first);
-	U32 second_length  = GetStringLength(second);
+Size_t StringCountByte(const U8* data, U8 byte, Size_t length) {
+	return g_stringKernels.count_byte(data, byte, length);
+}
 
-	
-	return SafeStringCompare(first, second, first_length, second_length);
+StrView StrView_FromCString(const char* text) {
+	return StrView_Make((const U8*)text, GetStringLength(text));
 }
 
+S8 StrView_Compare(StrView first, StrView second) {
+	return StringCompareLength(first.ptr, first.len, second.ptr, second.len);
+}
+
+Bool StrView_Equal(StrView first, StrView second) {
+	return StringEqualLength(first.ptr, first.len, second.ptr, second.len);
+}
+
+/* identifiers are short so a byte loop is fine */
+U32 StrView_Hash(StrView view) {
+	U32 hash = 2166136261u;
+	for (U32 i = 0; i < view.len; i++) {
+		hash ^= view.ptr[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
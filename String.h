@@ -4,4 +4,42 @@
 
 U32 GetStringLength(const char* buffer);
 S8 StringCompare(const U8* first, const U8* second);
+/* Same as StringCompare but for strings whose lengths are already known (need not be NUL-terminated) */
+S8 StringCompareLength(const U8* first, U32 first_length, const U8* second, U32 second_length);
+/* Cheaper than StringCompareLength when only equality matters, unequal lengths never touch the bytes */
+Bool StringEqualLength(const U8* first, U32 first_length, const U8* second, U32 second_length);
+/* First occurrence of byte in the length bytes at data, NULL if there is none */
+const U8* StringFindByte(const U8* data, U8 byte, Size_t length);
+/* Occurrences of byte in the length bytes at data */
+Size_t StringCountByte(const U8* data, U8 byte, Size_t length);
 
+/*
+	Non-owning view of len bytes. Views into source text are not NUL-terminated,
+	use the length, or STRVIEW_FMT / STRVIEW_ARG with printf-style functions.
+*/
+typedef struct strview_t {
+	const U8* ptr;
+	U32 len;
+} StrView;
+
+/* Static initializer for a view of a string literal, no strlen at run time */
+#define STRVIEW_INIT(literal) { (const U8*)(literal), sizeof(literal) - 1 }
+#define STRVIEW(literal) ((StrView) STRVIEW_INIT(literal))
+
+#define STRVIEW_FMT "%.*s"
+#define STRVIEW_ARG(view) (int)(view).len, (const char*)(view).ptr
+
+static inline StrView StrView_Make(const U8* ptr, U32 len) {
+	return (StrView) {.ptr= ptr, .len= len};
+}
+
+/* len bytes starting at start, the range must lie inside view */
+static inline StrView StrView_Slice(StrView view, U32 start, U32 len) {
+	return (StrView) {.ptr= view.ptr + start, .len= len};
+}
+
+StrView StrView_FromCString(const char* text);
+S8 StrView_Compare(StrView first, StrView second);
+Bool StrView_Equal(StrView first, StrView second);
+/* FNV-1a, the hash the interner uses */
+U32 StrView_Hash(StrView view);
@@ -0,0 +1,477 @@
+#include "StringKernels.h"
+#include "Memory_Win32.h"
+#include "Memory_Linux.h"
+#include "Simd.h"
+
+/* Past this a copy is left to the platform, which knows about rep movsb and non-temporal stores */
+#define STRING_COPY_PLATFORM_THRESHOLD 512
+
+static U32 LengthScalar(const char* text) {
+	const char* end = text;
+	while (*end) end++;
+	return (U32)(end - text);
+}
+
+static S32 CompareScalar(const U8* first, const U8* second) {
+	while (*first && *first == *second) {
+		first++;
+		second++;
+	}
+	return (S32)*first - (S32)*second;
+}
+
+static inline S32 CompareBytesScalar(const U8* first, const U8* second, U32 length) {
+	for (U32 i = 0; i < length; i++) {
+		if (first[i] != second[i]) return (S32)first[i] - (S32)second[i];
+	}
+	return 0;
+}
+
+static inline const U8* FindByteScalar(const U8* data, U8 byte, Size_t length) {
+	for (Size_t i = 0; i < length; i++) {
+		if (data[i] == byte) return data + i;
+	}
+	return NULL;
+}
+
+static Size_t CountByteScalar(const U8* data, U8 byte, Size_t length) {
+	Size_t count = 0;
+	for (Size_t i = 0; i < length; i++) {
+		count += data[i] == byte;
+	}
+	return count;
+}
+
+static void CopyPlatform(void* dest, const void* src, Size_t size) {
+#ifdef _WIN32
+	Win32_Memcpy(dest, src, size);
+#elif defined(__linux__)
+	Linux_Memcpy(dest, src, size);
+#endif
+}
+
+StringKernels g_stringKernels = {
+	.length = LengthScalar,
+	.compare = CompareScalar,
+	.compare_bytes = CompareBytesScalar,
+	.find_byte = FindByteScalar,
+	.count_byte = CountByteScalar,
+	.copy = CopyPlatform,
+	.name = (const U8*)"scalar",
+};
+
+#ifdef SIMD_X86
+/* Under 16 bytes, two overlapping 8-byte moves cover 8..15 */
+static inline void CopySmall(U8* dest, const U8* src, Size_t size) {
+	if (size >= 8) {
+		__m128i head = _mm_loadl_epi64((const __m128i*)src);
+		__m128i tail = _mm_loadl_epi64((const __m128i*)(src + size - 8));
+		_mm_storel_epi64((__m128i*)dest, head);
+		_mm_storel_epi64((__m128i*)(dest + size - 8), tail);
+		return;
+	}
+	for (Size_t i = 0; i < size; i++) dest[i] = src[i];
+}
+
+/*
+	Under 16 bytes one vector covers the whole range when the loads stay inside
+	their pages, lanes past length are masked off. Returns FALSE when a load
+	could cross into the next page and the caller has to go byte by byte.
+*/
+SIMD_NO_SANITIZE
+static inline Bool CompareBytesShort(const U8* first, const U8* second, U32 length, S32* result) {
+	if (!SIMD_LOAD_IS_SAFE(first, 16) || !SIMD_LOAD_IS_SAFE(second, 16)) return FALSE;
+
+	__m128i a = _mm_loadu_si128((const __m128i*)first);
+	__m128i b = _mm_loadu_si128((const __m128i*)second);
+	U32 differ = ((U32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF) & ((1u << length) - 1);
+	*result = differ ? (S32)first[SIMD_CTZ(differ)] - (S32)second[SIMD_CTZ(differ)] : 0;
+	return TRUE;
+}
+
+SIMD_NO_SANITIZE
+static inline Bool FindByteShort(const U8* data, U8 byte, U32 length, const U8** result) {
+	if (!SIMD_LOAD_IS_SAFE(data, 16)) return FALSE;
+
+	__m128i chunk = _mm_loadu_si128((const __m128i*)data);
+	U32 mask = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8((char)byte))) & ((1u << length) - 1);
+	*result = mask ? data + SIMD_CTZ(mask) : NULL;
+	return TRUE;
+}
+
+/* ---- SSE2, the x86-64 baseline ---- */
+
+SIMD_NO_SANITIZE
+static U32 LengthSSE2(const char* text) {
+	const U8* start = (const U8*)text;
+	const U8* block = (const U8*)((Size_t)start & ~(Size_t)15);
+	__m128i zero = _mm_setzero_si128();
+
+	/* the first aligned block may start before text, drop those lanes */
+	U32 mask = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)block), zero));
+	mask >>= (U32)(start - block);
+	if (mask) return SIMD_CTZ(mask);
+
+	for (;;) {
+		block += 16;
+		mask = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)block), zero));
+		if (mask) return (U32)(block - start) + SIMD_CTZ(mask);
+	}
+}
+
+SIMD_NO_SANITIZE
+static S32 CompareSSE2(const U8* first, const U8* second) {
+	__m128i zero = _mm_setzero_si128();
+	for (;;) {
+		if (!SIMD_LOAD_IS_SAFE(first, 16) || !SIMD_LOAD_IS_SAFE(second, 16)) {
+			/* close to a page end, go byte by byte until both loads are safe again */
+			if (*first == 0 || *first != *second) return (S32)*first - (S32)*second;
+			first++;
+			second++;
+			continue;
+		}
+
+		__m128i a = _mm_loadu_si128((const __m128i*)first);
+		__m128i b = _mm_loadu_si128((const __m128i*)second);
+		U32 differ = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+		U32 ended = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero));
+		U32 stop = differ | ended;
+		if (stop) {
+			U32 index = SIMD_CTZ(stop);
+			return (S32)first[index] - (S32)second[index];
+		}
+		first += 16;
+		second += 16;
+	}
+}
+
+static S32 CompareBytesSSE2(const U8* first, const U8* second, U32 length) {
+	S32 result;
+	if (length < 16 && CompareBytesShort(first, second, length, &result)) return result;
+
+	U32 i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(first + i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(second + i));
+		U32 differ = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+		if (differ) {
+			U32 index = i + SIMD_CTZ(differ);
+			return (S32)first[index] - (S32)second[index];
+		}
+	}
+	return CompareBytesScalar(first + i, second + i, length - i);
+}
+
+static const U8* FindByteSSE2(const U8* data, U8 byte, Size_t length) {
+	const U8* found;
+	if (length < 16 && FindByteShort(data, byte, (U32)length, &found)) return found;
+
+	__m128i needle = _mm_set1_epi8((char)byte);
+	Size_t i = 0;
+	for (; i + 16 <= length; i += 16) {
+		U32 mask = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), needle));
+		if (mask) return data + i + SIMD_CTZ(mask);
+	}
+	return FindByteScalar(data + i, byte, length - i);
+}
+
+/*
+	Matches are counted in 16 byte-wide lanes (a match is -1, subtracting it adds
+	one) and the lanes are summed with PSADBW before any of them can wrap.
+*/
+#define STRING_COUNT_FLUSH 255
+
+static Size_t CountByteSSE2(const U8* data, U8 byte, Size_t length) {
+	__m128i needle = _mm_set1_epi8((char)byte);
+	__m128i zero = _mm_setzero_si128();
+	__m128i total = zero;
+	Size_t i = 0;
+	while (i + 16 <= length) {
+		__m128i lanes = zero;
+		for (U32 round = 0; round < STRING_COUNT_FLUSH && i + 16 <= length; round++, i += 16) {
+			lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), needle));
+		}
+		total = _mm_add_epi64(total, _mm_sad_epu8(lanes, zero));
+	}
+	Size_t count = (Size_t)_mm_cvtsi128_si64(total) + (Size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(total, total));
+	return count + CountByteScalar(data + i, byte, length - i);
+}
+
+static void CopySSE2(void* dest, const void* src, Size_t size) {
+	U8* out = dest;
+	const U8* in = src;
+	if (size < 16) {
+		CopySmall(out, in, size);
+		return;
+	}
+	if (size > STRING_COPY_PLATFORM_THRESHOLD) {
+		CopyPlatform(dest, src, size);
+		return;
+	}
+
+	/* the last vector overlaps the loop's final one instead of a byte tail */
+	__m128i last = _mm_loadu_si128((const __m128i*)(in + size - 16));
+	for (Size_t i = 0; i + 16 < size; i += 16) {
+		_mm_storeu_si128((__m128i*)(out + i), _mm_loadu_si128((const __m128i*)(in + i)));
+	}
+	_mm_storeu_si128((__m128i*)(out + size - 16), last);
+}
+
+/* ---- AVX2 ---- */
+
+/*
+	The AVX2 kernels keep their tails in AVX2 code (the scalar helpers inline
+	into them) instead of calling the SSE2 versions, calls between the two
+	encodings cost a state transition on some cores.
+*/
+
+SIMD_TARGET_AVX2 SIMD_NO_SANITIZE
+static inline U32 ZeroMaskAVX2(const U8* block) {
+	return (U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i*)block), _mm256_setzero_si256()));
+}
+
+SIMD_TARGET_AVX2 SIMD_NO_SANITIZE
+static U32 LengthAVX2(const char* text) {
+	const U8* start = (const U8*)text;
+	const U8* block = (const U8*)((Size_t)start & ~(Size_t)31);
+
+	U32 mask = ZeroMaskAVX2(block) >> (U32)(start - block);
+	if (mask) return SIMD_CTZ(mask);
+
+	/* single vectors up to a 128-byte boundary, then four at a time */
+	for (block += 32; (Size_t)block & 127; block += 32) {
+		mask = ZeroMaskAVX2(block);
+		if (mask) return (U32)(block - start) + SIMD_CTZ(mask);
+	}
+	for (;; block += 128) {
+		__m256i a = _mm256_load_si256((const __m256i*)block);
+		__m256i b = _mm256_load_si256((const __m256i*)(block + 32));
+		__m256i c = _mm256_load_si256((const __m256i*)(block + 64));
+		__m256i d = _mm256_load_si256((const __m256i*)(block + 96));
+		__m256i low = _mm256_min_epu8(_mm256_min_epu8(a, b), _mm256_min_epu8(c, d));
+		if (!_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, _mm256_setzero_si256()))) continue;
+
+		for (U32 offset = 0;; offset += 32) {
+			mask = ZeroMaskAVX2(block + offset);
+			if (mask) return (U32)(block + offset - start) + SIMD_CTZ(mask);
+		}
+	}
+}
+
+SIMD_TARGET_AVX2 SIMD_NO_SANITIZE
+static S32 CompareAVX2(const U8* first, const U8* second) {
+	__m256i zero = _mm256_setzero_si256();
+	for (;;) {
+		if (!SIMD_LOAD_IS_SAFE(first, 32) || !SIMD_LOAD_IS_SAFE(second, 32)) {
+			if (*first == 0 || *first != *second) return (S32)*first - (S32)*second;
+			first++;
+			second++;
+			continue;
+		}
+
+		__m256i a = _mm256_loadu_si256((const __m256i*)first);
+		__m256i b = _mm256_loadu_si256((const __m256i*)second);
+		U32 differ = ~(U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+		U32 ended = (U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, zero));
+		U32 stop = differ | ended;
+		if (stop) {
+			U32 index = SIMD_CTZ(stop);
+			return (S32)first[index] - (S32)second[index];
+		}
+		first += 32;
+		second += 32;
+	}
+}
+
+SIMD_TARGET_AVX2
+static inline U32 DifferMaskAVX2(const U8* first, const U8* second) {
+	__m256i a = _mm256_loadu_si256((const __m256i*)first);
+	__m256i b = _mm256_loadu_si256((const __m256i*)second);
+	return ~(U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+}
+
+SIMD_TARGET_AVX2
+static S32 CompareBytesAVX2(const U8* first, const U8* second, U32 length) {
+	if (length < 32) {
+		if (length >= 16) {
+			/* two overlapping 16-byte compares cover 16..31 */
+			__m128i a = _mm_loadu_si128((const __m128i*)first);
+			__m128i b = _mm_loadu_si128((const __m128i*)second);
+			U32 differ = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+			U32 base = 0;
+			if (!differ) {
+				base = length - 16;
+				a = _mm_loadu_si128((const __m128i*)(first + base));
+				b = _mm_loadu_si128((const __m128i*)(second + base));
+				differ = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+				if (!differ) return 0;
+			}
+			U32 index = base + SIMD_CTZ(differ);
+			return (S32)first[index] - (S32)second[index];
+		}
+		S32 result;
+		if (CompareBytesShort(first, second, length, &result)) return result;
+		if (length >= 8) {
+			/* same with two overlapping 8-byte halves for 8..15 */
+			__m128i a = _mm_loadl_epi64((const __m128i*)first);
+			__m128i b = _mm_loadl_epi64((const __m128i*)second);
+			U32 differ = ((U32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFF) ^ 0xFF;
+			U32 base = 0;
+			if (!differ) {
+				base = length - 8;
+				a = _mm_loadl_epi64((const __m128i*)(first + base));
+				b = _mm_loadl_epi64((const __m128i*)(second + base));
+				differ = ((U32)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFF) ^ 0xFF;
+				if (!differ) return 0;
+			}
+			U32 index = base + SIMD_CTZ(differ);
+			return (S32)first[index] - (S32)second[index];
+		}
+		return CompareBytesScalar(first, second, length);
+	}
+
+	U32 i = 0;
+	for (; i + 64 <= length; i += 64) {
+		U32 low = DifferMaskAVX2(first + i, second + i);
+		U32 high = DifferMaskAVX2(first + i + 32, second + i + 32);
+		if (low | high) {
+			U32 index = i + (low ? SIMD_CTZ(low) : 32 + SIMD_CTZ(high));
+			return (S32)first[index] - (S32)second[index];
+		}
+	}
+	if (i < length) {
+		/* the bytes before i are equal, so an overlapping last vector finds the first difference */
+		U32 base = i + 32 <= length ? i : length - 32;
+		U32 differ = DifferMaskAVX2(first + base, second + base);
+		if (!differ && base + 32 < length) {
+			base = length - 32;
+			differ = DifferMaskAVX2(first + base, second + base);
+		}
+		if (differ) {
+			U32 index = base + SIMD_CTZ(differ);
+			return (S32)first[index] - (S32)second[index];
+		}
+	}
+	return 0;
+}
+
+SIMD_TARGET_AVX2
+static inline U32 MatchMaskAVX2(const U8* data, __m256i needle) {
+	return (U32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)data), needle));
+}
+
+SIMD_TARGET_AVX2
+static const U8* FindByteAVX2(const U8* data, U8 byte, Size_t length) {
+	if (length < 32) {
+		if (length < 16) {
+			const U8* found;
+			if (FindByteShort(data, byte, (U32)length, &found)) return found;
+			return FindByteScalar(data, byte, length);
+		}
+		__m128i small_needle = _mm_set1_epi8((char)byte);
+		U32 mask = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)data), small_needle));
+		if (mask) return data + SIMD_CTZ(mask);
+		mask = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + length - 16)), small_needle));
+		return mask ? data + length - 16 + SIMD_CTZ(mask) : NULL;
+	}
+
+	__m256i needle = _mm256_set1_epi8((char)byte);
+	Size_t i = 0;
+	for (; i + 128 <= length; i += 128) {
+		__m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), needle);
+		__m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 32)), needle);
+		__m256i c = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 64)), needle);
+		__m256i d = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 96)), needle);
+		if (!_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)))) continue;
+		break;
+	}
+	for (; i + 32 <= length; i += 32) {
+		U32 mask = MatchMaskAVX2(data + i, needle);
+		if (mask) return data + i + SIMD_CTZ(mask);
+	}
+	if (i < length) {
+		/* overlapping last vector, nothing before i matched */
+		U32 mask = MatchMaskAVX2(data + length - 32, needle);
+		if (mask) return data + length - 32 + SIMD_CTZ(mask);
+	}
+	return NULL;
+}
+
+SIMD_TARGET_AVX2
+static Size_t CountByteAVX2(const U8* data, U8 byte, Size_t length) {
+	__m256i needle = _mm256_set1_epi8((char)byte);
+	__m256i zero = _mm256_setzero_si256();
+	__m256i total = zero;
+	Size_t i = 0;
+	while (i + 32 <= length) {
+		__m256i lanes = zero;
+		for (U32 round = 0; round < STRING_COUNT_FLUSH && i + 32 <= length; round++, i += 32) {
+			lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), needle));
+		}
+		total = _mm256_add_epi64(total, _mm256_sad_epu8(lanes, zero));
+	}
+	__m128i half = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+	if (i + 16 <= length) {
+		__m128i lanes = _mm_sub_epi8(_mm_setzero_si128(), _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), _mm256_castsi256_si128(needle)));
+		half = _mm_add_epi64(half, _mm_sad_epu8(lanes, _mm_setzero_si128()));
+		i += 16;
+	}
+	Size_t count = (Size_t)_mm_cvtsi128_si64(half) + (Size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(half, half));
+	return count + CountByteScalar(data + i, byte, length - i);
+}
+
+SIMD_TARGET_AVX2
+static void CopyAVX2(void* dest, const void* src, Size_t size) {
+	U8* out = dest;
+	const U8* in = src;
+	if (size < 32) {
+		if (size >= 16) {
+			__m128i head = _mm_loadu_si128((const __m128i*)in);
+			__m128i tail = _mm_loadu_si128((const __m128i*)(in + size - 16));
+			_mm_storeu_si128((__m128i*)out, head);
+			_mm_storeu_si128((__m128i*)(out + size - 16), tail);
+			return;
+		}
+		CopySmall(out, in, size);
+		return;
+	}
+	if (size > STRING_COPY_PLATFORM_THRESHOLD) {
+		CopyPlatform(dest, src, size);
+		return;
+	}
+
+	__m256i last = _mm256_loadu_si256((const __m256i*)(in + size - 32));
+	for (Size_t i = 0; i + 32 < size; i += 32) {
+		_mm256_storeu_si256((__m256i*)(out + i), _mm256_loadu_si256((const __m256i*)(in + i)));
+	}
+	_mm256_storeu_si256((__m256i*)(out + size - 32), last);
+}
+#endif
+
+void StringKernelsInit(const CPUInfo* info) {
+#ifdef SIMD_X86
+	if (info->has_avx2) {
+		g_stringKernels = (StringKernels) {
+			.length = LengthAVX2,
+			.compare = CompareAVX2,
+			.compare_bytes = CompareBytesAVX2,
+			.find_byte = FindByteAVX2,
+			.count_byte = CountByteAVX2,
+			.copy = CopyAVX2,
+			.name = (const U8*)"avx2",
+		};
+		return;
+	}
+
+	/* SSE2 is part of x86-64, no feature bit to check */
+	g_stringKernels = (StringKernels) {
+		.length = LengthSSE2,
+		.compare = CompareSSE2,
+		.compare_bytes = CompareBytesSSE2,
+		.find_byte = FindByteSSE2,
+		.count_byte = CountByteSSE2,
+		.copy = CopySSE2,
+		.name = (const U8*)"sse2",
+	};
+#endif
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Common.h"
+#include "CPU.h"
+
+/*
+	Byte-string primitives behind String.h and Memcpy, selected at startup.
+	The scalar set is portable and is what runs until StringKernelsInit.
+*/
+typedef struct stringkernels_t {
+	U32 (*length)(const char* text);
+	/* NUL-terminated comparison, < 0, 0 or > 0 like strcmp */
+	S32 (*compare)(const U8* first, const U8* second);
+	/* Compares exactly length bytes like memcmp */
+	S32 (*compare_bytes)(const U8* first, const U8* second, U32 length);
+	const U8* (*find_byte)(const U8* data, U8 byte, Size_t length);
+	Size_t (*count_byte)(const U8* data, U8 byte, Size_t length);
+	void (*copy)(void* dest, const void* src, Size_t size);
+	const U8* name;
+} StringKernels;
+
+extern StringKernels g_stringKernels;
+
+void StringKernelsInit(const CPUInfo* info);
@@ -0,0 +1,105 @@
+#include "Thread.h"
+#include "Thread_Win32.h"
+#include "Thread_Linux.h"
+
+Thread* Thread_Create(ThreadFn fn, void* arg) {
+	Thread* result = NULL;
+#ifdef _WIN32
+	result = Win32_ThreadCreate(fn, arg);
+#elif defined(__linux__)
+	result = Linux_ThreadCreate(fn, arg);
+#endif
+	return result;
+}
+
+void Thread_Join(Thread* thread) {
+#ifdef _WIN32
+	Win32_ThreadJoin(thread);
+#elif defined(__linux__)
+	Linux_ThreadJoin(thread);
+#endif
+}
+
+void Thread_Yield(void) {
+#ifdef _WIN32
+	Win32_ThreadYield();
+#elif defined(__linux__)
+	Linux_ThreadYield();
+#endif
+}
+
+Mutex* Mutex_Create(void) {
+	Mutex* result = NULL;
+#ifdef _WIN32
+	result = Win32_MutexCreate();
+#elif defined(__linux__)
+	result = Linux_MutexCreate();
+#endif
+	return result;
+}
+
+void Mutex_Lock(Mutex* mutex) {
+#ifdef _WIN32
+	Win32_MutexLock(mutex);
+#elif defined(__linux__)
+	Linux_MutexLock(mutex);
+#endif
+}
+
+void Mutex_Unlock(Mutex* mutex) {
+#ifdef _WIN32
+	Win32_MutexUnlock(mutex);
+#elif defined(__linux__)
+	Linux_MutexUnlock(mutex);
+#endif
+}
+
+void Mutex_Destroy(Mutex* mutex) {
+#ifdef _WIN32
+	Win32_MutexDestroy(mutex);
+#elif defined(__linux__)
+	Linux_MutexDestroy(mutex);
+#endif
+}
+
+CondVar* CondVar_Create(void) {
+	CondVar* result = NULL;
+#ifdef _WIN32
+	result = Win32_CondVarCreate();
+#elif defined(__linux__)
+	result = Linux_CondVarCreate();
+#endif
+	return result;
+}
+
+void CondVar_Wait(CondVar* condvar, Mutex* mutex) {
+#ifdef _WIN32
+	Win32_CondVarWait(condvar, mutex);
+#elif defined(__linux__)
+	Linux_CondVarWait(condvar, mutex);
+#endif
+}
+
+void CondVar_Signal(CondVar* condvar) {
+#ifdef _WIN32
+	Win32_CondVarSignal(condvar);
+#elif defined(__linux__)
+	Linux_CondVarSignal(condvar);
+#endif
+}
+
+void CondVar_Broadcast(CondVar* condvar) {
+#ifdef _WIN32
+	Win32_CondVarBroadcast(condvar);
+#elif defined(__linux__)
+	Linux_CondVarBroadcast(condvar);
+#endif
+}
+
+void CondVar_Destroy(CondVar* condvar) {
+#ifdef _WIN32
+	Win32_CondVarDestroy(condvar);
+#elif defined(__linux__)
+	Linux_CondVarDestroy(condvar);
+#endif
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Common.h"
+
+/* Opaque, the layout is owned by the platform backend */
+typedef struct thread_t Thread;
+typedef struct mutex_t Mutex;
+typedef struct condvar_t CondVar;
+
+typedef void (*ThreadFn)(void* arg);
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+Thread* Thread_Create(ThreadFn fn, void* arg);
+void Thread_Join(Thread* thread);
+void Thread_Yield(void);
+
+Mutex* Mutex_Create(void);
+void Mutex_Lock(Mutex* mutex);
+void Mutex_Unlock(Mutex* mutex);
+void Mutex_Destroy(Mutex* mutex);
+
+CondVar* CondVar_Create(void);
+void CondVar_Wait(CondVar* condvar, Mutex* mutex);
+void CondVar_Signal(CondVar* condvar);
+void CondVar_Broadcast(CondVar* condvar);
+void CondVar_Destroy(CondVar* condvar);
@@ -0,0 +1,191 @@
+#include "ThreadPool.h"
+#include "Memory.h"
+#include "Logger.h"
+#include "Profile.h"
+
+#define THREADPOOL_INITIAL_QUEUE_CAPACITY 64
+#define THREADPOOL_EXTERNAL_WORKER        0xFFFFFFFF
+
+typedef struct workerstart_t {
+	ThreadPool* pool;
+	U32 index;
+} WorkerStart;
+
+static THREAD_LOCAL U32 g_workerIndex = THREADPOOL_EXTERNAL_WORKER;
+
+static U32 CurrentWorkerIndex(const ThreadPool* pool) {
+	/* every thread outside the pool shares the last slot */
+	return g_workerIndex == THREADPOOL_EXTERNAL_WORKER ? pool->thread_count : g_workerIndex;
+}
+
+/* Must be called with the pool mutex held */
+static Bool QueuePop(ThreadPool* pool, Job* job) {
+	if (pool->queue_count == 0) return FALSE;
+	*job = pool->queue[pool->queue_head];
+	pool->queue_head = (pool->queue_head + 1) % pool->queue_capacity;
+	pool->queue_count--;
+	return TRUE;
+}
+
+/*
+	Must be called with the pool mutex held. Takes the oldest job of group out
+	of the queue, wherever it sits, and closes the hole behind it.
+*/
+static Bool QueuePopGroup(ThreadPool* pool, const JobGroup* group, Job* job) {
+	for (U32 i = 0; i < pool->queue_count; i++) {
+		U32 slot = (pool->queue_head + i) % pool->queue_capacity;
+		if (pool->queue[slot].group != group) continue;
+
+		*job = pool->queue[slot];
+		for (U32 k = i + 1; k < pool->queue_count; k++) {
+			U32 next = (pool->queue_head + k) % pool->queue_capacity;
+			pool->queue[slot] = pool->queue[next];
+			slot = next;
+		}
+		pool->queue_count--;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+static void QueuePush(ThreadPool* pool, Job job) {
+	if (pool->queue_count == pool->queue_capacity) {
+		U32 new_capacity = pool->queue_capacity * 2;
+		Job* queue = Malloc(new_capacity * sizeof(*queue));
+		if (queue == NULL) {
+			PANIC("Malloc Failed");
+		}
+		for (U32 i = 0; i < pool->queue_count; i++) {
+			queue[i] = pool->queue[(pool->queue_head + i) % pool->queue_capacity];
+		}
+		Free(pool->queue);
+		pool->queue = queue;
+		pool->queue_head = 0;
+		pool->queue_capacity = new_capacity;
+	}
+
+	U32 tail = (pool->queue_head + pool->queue_count) % pool->queue_capacity;
+	pool->queue[tail] = job;
+	pool->queue_count++;
+}
+
+/* Runs the job without the lock, then retires it from its group */
+static void RunJob(ThreadPool* pool, Job job) {
+	Mutex_Unlock(pool->mutex);
+	job.fn(job.arg, CurrentWorkerIndex(pool));
+	Mutex_Lock(pool->mutex);
+
+	job.group->pending--;
+	if (job.group->pending == 0) {
+		CondVar_Broadcast(pool->job_finished);
+	}
+}
+
+static void WorkerMain(void* arg) {
+	WorkerStart* start = arg;
+	ThreadPool* pool = start->pool;
+	g_workerIndex = start->index;
+	Profile_SetThreadName("worker", start->index);
+	Free(start);
+
+	Mutex_Lock(pool->mutex);
+	for (;;) {
+		Job job;
+		if (QueuePop(pool, &job)) {
+			RunJob(pool, job);
+			continue;
+		}
+		if (pool->shutting_down) break;
+		CondVar_Wait(pool->work_available, pool->mutex);
+	}
+	Mutex_Unlock(pool->mutex);
+}
+
+ThreadPool* ThreadPool_Create(U32 thread_count) {
+	ThreadPool* pool = Malloc(sizeof(*pool));
+	if (pool == NULL) return NULL;
+
+	pool->thread_count = 0;
+	pool->threads = Malloc((thread_count ? thread_count : 1) * sizeof(*pool->threads));
+	pool->queue = Malloc(THREADPOOL_INITIAL_QUEUE_CAPACITY * sizeof(*pool->queue));
+	pool->queue_head = 0;
+	pool->queue_count = 0;
+	pool->queue_capacity = THREADPOOL_INITIAL_QUEUE_CAPACITY;
+	pool->mutex = Mutex_Create();
+	pool->work_available = CondVar_Create();
+	pool->job_finished = CondVar_Create();
+	pool->shutting_down = FALSE;
+
+	if (pool->threads == NULL || pool->queue == NULL || pool->mutex == NULL ||
+		pool->work_available == NULL || pool->job_finished == NULL) {
+		PANIC("Couldn't create thread pool");
+	}
+
+	/* workers are registered under the lock so an early job sees a stable thread_count */
+	Mutex_Lock(pool->mutex);
+	for (U32 i = 0; i < thread_count; i++) {
+		WorkerStart* start = Malloc(sizeof(*start));
+		start->pool = pool;
+		start->index = i;
+
+		Thread* thread = Thread_Create(WorkerMain, start);
+		if (thread == NULL) {
+			Free(start);
+			break;
+		}
+		pool->threads[pool->thread_count++] = thread;
+	}
+	Mutex_Unlock(pool->mutex);
+
+	return pool;
+}
+
+void ThreadPool_Destroy(ThreadPool* pool) {
+	if (pool == NULL) return;
+
+	Mutex_Lock(pool->mutex);
+	pool->shutting_down = TRUE;
+	CondVar_Broadcast(pool->work_available);
+	Mutex_Unlock(pool->mutex);
+
+	for (U32 i = 0; i < pool->thread_count; i++) {
+		Thread_Join(pool->threads[i]);
+	}
+
+	Mutex_Destroy(pool->mutex);
+	CondVar_Destroy(pool->work_available);
+	CondVar_Destroy(pool->job_finished);
+	Free(pool->threads);
+	Free(pool->queue);
+	Free(pool);
+}
+
+void ThreadPool_Submit(ThreadPool* pool, JobGroup* group, JobFn fn, void* arg) {
+	Mutex_Lock(pool->mutex);
+	group->pending++;
+	QueuePush(pool, (Job) {.fn= fn, .arg= arg, .group= group});
+	CondVar_Signal(pool->work_available);
+	Mutex_Unlock(pool->mutex);
+}
+
+/*
+	Only jobs of the awaited group are helped with. Running any queued job here
+	would nest an unrelated one (another file) on this stack, sharing this
+	worker's per-slot state and delaying the waiter behind it.
+*/
+void ThreadPool_Wait(ThreadPool* pool, JobGroup* group) {
+	Mutex_Lock(pool->mutex);
+	while (group->pending != 0) {
+		Job job;
+		if (QueuePopGroup(pool, group, &job)) {
+			RunJob(pool, job);
+			continue;
+		}
+		CondVar_Wait(pool->job_finished, pool->mutex);
+	}
+	Mutex_Unlock(pool->mutex);
+}
+
+U32 ThreadPool_GetWorkerSlots(const ThreadPool* pool) {
+	return pool->thread_count + 1;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "Common.h"
+#include "Thread.h"
+
+/* worker_index identifies the thread running the job, see ThreadPool_GetWorkerSlots */
+typedef void (*JobFn)(void* arg, U32 worker_index);
+
+typedef struct job_t {
+	JobFn fn;
+	void* arg;
+	struct jobgroup_t* group;
+} Job;
+
+/* Counts the outstanding jobs submitted against it, waited on with ThreadPool_Wait */
+typedef struct jobgroup_t {
+	U32 pending;
+} JobGroup;
+
+/*
+	Fixed set of worker threads pulling jobs from one FIFO queue.
+	Threads that wait on a group run that group's queued jobs while they wait,
+	so jobs may submit and wait on nested groups without deadlocking the pool:
+	a group's jobs are always either queued, and the waiter can take them, or
+	already running. A waiter never picks up unrelated jobs, nesting on its
+	stack only goes as deep as the groups themselves nest.
+*/
+typedef struct threadpool_t {
+	Thread** threads;
+	U32 thread_count;
+
+	Job* queue;             // ring buffer
+	U32 queue_head;
+	U32 queue_count;
+	U32 queue_capacity;
+
+	Mutex* mutex;
+	CondVar* work_available;
+	CondVar* job_finished;
+	Bool shutting_down;
+} ThreadPool;
+
+/* thread_count workers are started, the creating thread takes part when it waits */
+ThreadPool* ThreadPool_Create(U32 thread_count);
+void ThreadPool_Destroy(ThreadPool* pool);
+
+void ThreadPool_Submit(ThreadPool* pool, JobGroup* group, JobFn fn, void* arg);
+void ThreadPool_Wait(ThreadPool* pool, JobGroup* group);
+
+/*
+	Number of distinct worker_index values jobs can observe: one per worker
+	thread plus one for threads outside the pool (they help while waiting).
+	Per-worker state can be kept in an array of this size, as long as only one
+	thread outside the pool waits on it at a time.
+*/
+U32 ThreadPool_GetWorkerSlots(const ThreadPool* pool);
@@ -0,0 +1,95 @@
+#ifdef __linux__
+#include "Thread_Linux.h"
+#include "Memory.h"
+#include "Logger.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+struct thread_t {
+	pthread_t handle;
+	ThreadFn fn;
+	void* arg;
+};
+
+struct mutex_t {
+	pthread_mutex_t handle;
+};
+
+struct condvar_t {
+	pthread_cond_t handle;
+};
+
+static void* ThreadEntry(void* param) {
+	Thread* thread = param;
+	thread->fn(thread->arg);
+	return NULL;
+}
+
+Thread* Linux_ThreadCreate(ThreadFn fn, void* arg) {
+	Thread* thread = Malloc(sizeof(*thread));
+	if (thread == NULL) return NULL;
+
+	thread->fn = fn;
+	thread->arg = arg;
+	if (pthread_create(&thread->handle, NULL, ThreadEntry, thread) != 0) {
+		LOG_ERROR("pthread_create failed\n");
+		Free(thread);
+		return NULL;
+	}
+	return thread;
+}
+
+void Linux_ThreadJoin(Thread* thread) {
+	pthread_join(thread->handle, NULL);
+	Free(thread);
+}
+
+void Linux_ThreadYield(void) {
+	sched_yield();
+}
+
+Mutex* Linux_MutexCreate(void) {
+	Mutex* mutex = Malloc(sizeof(*mutex));
+	if (mutex == NULL) return NULL;
+	pthread_mutex_init(&mutex->handle, NULL);
+	return mutex;
+}
+
+void Linux_MutexLock(Mutex* mutex) {
+	pthread_mutex_lock(&mutex->handle);
+}
+
+void Linux_MutexUnlock(Mutex* mutex) {
+	pthread_mutex_unlock(&mutex->handle);
+}
+
+void Linux_MutexDestroy(Mutex* mutex) {
+	pthread_mutex_destroy(&mutex->handle);
+	Free(mutex);
+}
+
+CondVar* Linux_CondVarCreate(void) {
+	CondVar* condvar = Malloc(sizeof(*condvar));
+	if (condvar == NULL) return NULL;
+	pthread_cond_init(&condvar->handle, NULL);
+	return condvar;
+}
+
+void Linux_CondVarWait(CondVar* condvar, Mutex* mutex) {
+	pthread_cond_wait(&condvar->handle, &mutex->handle);
+}
+
+void Linux_CondVarSignal(CondVar* condvar) {
+	pthread_cond_signal(&condvar->handle);
+}
+
+void Linux_CondVarBroadcast(CondVar* condvar) {
+	pthread_cond_broadcast(&condvar->handle);
+}
+
+void Linux_CondVarDestroy(CondVar* condvar) {
+	pthread_cond_destroy(&condvar->handle);
+	Free(condvar);
+}
+#endif
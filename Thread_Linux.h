@@ -0,0 +1,17 @@
+#pragma once
+#include "Thread.h"
+
+Thread* Linux_ThreadCreate(ThreadFn fn, void* arg);
+void Linux_ThreadJoin(Thread* thread);
+void Linux_ThreadYield(void);
+
+Mutex* Linux_MutexCreate(void);
+void Linux_MutexLock(Mutex* mutex);
+void Linux_MutexUnlock(Mutex* mutex);
+void Linux_MutexDestroy(Mutex* mutex);
+
+CondVar* Linux_CondVarCreate(void);
+void Linux_CondVarWait(CondVar* condvar, Mutex* mutex);
+void Linux_CondVarSignal(CondVar* condvar);
+void Linux_CondVarBroadcast(CondVar* condvar);
+void Linux_CondVarDestroy(CondVar* condvar);
@@ -0,0 +1,92 @@
+#include "Thread_Win32.h"
+#include "Memory.h"
+#include "Logger.h"
+
+#include <windows.h>
+
+struct thread_t {
+	HANDLE handle;
+	ThreadFn fn;
+	void* arg;
+};
+
+struct mutex_t {
+	SRWLOCK handle;
+};
+
+struct condvar_t {
+	CONDITION_VARIABLE handle;
+};
+
+static DWORD WINAPI ThreadEntry(LPVOID param) {
+	Thread* thread = param;
+	thread->fn(thread->arg);
+	return 0;
+}
+
+Thread* Win32_ThreadCreate(ThreadFn fn, void* arg) {
+	Thread* thread = Malloc(sizeof(*thread));
+	if (thread == NULL) return NULL;
+
+	thread->fn = fn;
+	thread->arg = arg;
+	thread->handle = CreateThread(NULL, 0, ThreadEntry, thread, 0, NULL);
+	if (thread->handle == NULL) {
+		LOG_ERROR("CreateThread failed\n");
+		Free(thread);
+		return NULL;
+	}
+	return thread;
+}
+
+void Win32_ThreadJoin(Thread* thread) {
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+	Free(thread);
+}
+
+void Win32_ThreadYield(void) {
+	SwitchToThread();
+}
+
+Mutex* Win32_MutexCreate(void) {
+	Mutex* mutex = Malloc(sizeof(*mutex));
+	if (mutex == NULL) return NULL;
+	InitializeSRWLock(&mutex->handle);
+	return mutex;
+}
+
+void Win32_MutexLock(Mutex* mutex) {
+	AcquireSRWLockExclusive(&mutex->handle);
+}
+
+void Win32_MutexUnlock(Mutex* mutex) {
+	ReleaseSRWLockExclusive(&mutex->handle);
+}
+
+void Win32_MutexDestroy(Mutex* mutex) {
+	Free(mutex);
+}
+
+CondVar* Win32_CondVarCreate(void) {
+	CondVar* condvar = Malloc(sizeof(*condvar));
+	if (condvar == NULL) return NULL;
+	InitializeConditionVariable(&condvar->handle);
+	return condvar;
+}
+
+void Win32_CondVarWait(CondVar* condvar, Mutex* mutex) {
+	SleepConditionVariableSRW(&condvar->handle, &mutex->handle, INFINITE, 0);
+}
+
+void Win32_CondVarSignal(CondVar* condvar) {
+	WakeConditionVariable(&condvar->handle);
+}
+
+void Win32_CondVarBroadcast(CondVar* condvar) {
+	WakeAllConditionVariable(&condvar->handle);
+}
+
+void Win32_CondVarDestroy(CondVar* condvar) {
+	Free(condvar);
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "Thread.h"
+
+Thread* Win32_ThreadCreate(ThreadFn fn, void* arg);
+void Win32_ThreadJoin(Thread* thread);
+void Win32_ThreadYield(void);
+
+Mutex* Win32_MutexCreate(void);
+void Win32_MutexLock(Mutex* mutex);
+void Win32_MutexUnlock(Mutex* mutex);
+void Win32_MutexDestroy(Mutex* mutex);
+
+CondVar* Win32_CondVarCreate(void);
+void Win32_CondVarWait(CondVar* condvar, Mutex* mutex);
+void Win32_CondVarSignal(CondVar* condvar);
+void Win32_CondVarBroadcast(CondVar* condvar);
+void Win32_CondVarDestroy(CondVar* condvar);
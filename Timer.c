@@ -0,0 +1,13 @@
+#include "Timer.h"
+#include "Timer_Win32.h"
+#include "Timer_Linux.h"
+
+U64 Timer_Now(void) {
+	U64 now = 0;
+#ifdef _WIN32
+	now = Win32_TimerNow();
+#elif defined(__linux__)
+	now = Linux_TimerNow();
+#endif
+	return now;
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include "Common.h"
+
+/* Monotonic, high-resolution clock in nanoseconds from an arbitrary origin */
+U64 Timer_Now(void);
@@ -0,0 +1,11 @@
+#ifdef __linux__
+#include "Timer_Linux.h"
+
+#include <time.h>
+
+U64 Linux_TimerNow(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (U64)now.tv_sec * 1000000000ull + (U64)now.tv_nsec;
+}
+#endif
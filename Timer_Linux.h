@@ -0,0 +1,4 @@
+#pragma once
+#include "Common.h"
+
+U64 Linux_TimerNow(void);
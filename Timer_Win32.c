@@ -0,0 +1,19 @@
+#include "Timer_Win32.h"
+
+#include <windows.h>
+
+static LARGE_INTEGER g_timerFrequency = {0};
+
+U64 Win32_TimerNow(void) {
+	if (g_timerFrequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&g_timerFrequency);
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	/* split to avoid overflowing the multiplication on long uptimes */
+	U64 seconds = counter.QuadPart / g_timerFrequency.QuadPart;
+	U64 remainder = counter.QuadPart % g_timerFrequency.QuadPart;
+	return seconds * 1000000000ull + (remainder * 1000000000ull) / g_timerFrequency.QuadPart;
+}
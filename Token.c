@@ -0,0 +1,165 @@
+#include "Token.h"
+#include "Memory.h"
+#include "Logger.h"
+#include "String.h"
+
+U32 TokenBuffer_EstimateCapacity(Size_t source_size) {
+	Size_t estimate = source_size / TOKEN_BYTES_PER_TOKEN_ESTIMATE + 16;
+	return estimate > 0xFFFFFFFF ? 0xFFFFFFFF : (U32)estimate;
+}
+
+TokenBuffer* TokenBuffer_Create(U32 capacity, const U8* source) {
+	if (capacity == 0) capacity = 1;
+
+	TokenBuffer* tokens = Malloc(sizeof(*tokens));
+	if (tokens == NULL) return NULL;
+
+	tokens->kind = Malloc(capacity * sizeof(*tokens->kind));
+	tokens->start = Malloc(capacity * sizeof(*tokens->start));
+	tokens->length = Malloc(capacity * sizeof(*tokens->length));
+	tokens->value = Malloc(capacity * sizeof(*tokens->value));
+	if (tokens->kind == NULL || tokens->start == NULL || tokens->length == NULL || tokens->value == NULL) {
+		TokenBuffer_Free(tokens);
+		return NULL;
+	}
+
+	tokens->count = 0;
+	tokens->capacity = capacity;
+	tokens->tail = 0;
+	tokens->tail_shift = 0;
+	tokens->source = source;
+	return tokens;
+}
+
+static void TokenBufferSetCapacity(TokenBuffer* tokens, U32 capacity) {
+	U32 old_tail = tokens->capacity - tokens->tail;
+	tokens->capacity = capacity;
+	tokens->kind = Realloc(tokens->kind, tokens->capacity * sizeof(*tokens->kind));
+	tokens->start = Realloc(tokens->start, tokens->capacity * sizeof(*tokens->start));
+	tokens->length = Realloc(tokens->length, tokens->capacity * sizeof(*tokens->length));
+	tokens->value = Realloc(tokens->value, tokens->capacity * sizeof(*tokens->value));
+	if (tokens->kind == NULL || tokens->start == NULL || tokens->length == NULL || tokens->value == NULL) {
+		PANIC("Realloc Failed");
+	}
+
+	/* the tail stays at the end of the arrays */
+	if (tokens->tail != 0) {
+		U32 new_tail = capacity - tokens->tail;
+		Memmove(tokens->kind + new_tail, tokens->kind + old_tail, (Size_t)tokens->tail * sizeof(*tokens->kind));
+		Memmove(tokens->start + new_tail, tokens->start + old_tail, (Size_t)tokens->tail * sizeof(*tokens->start));
+		Memmove(tokens->length + new_tail, tokens->length + old_tail, (Size_t)tokens->tail * sizeof(*tokens->length));
+		Memmove(tokens->value + new_tail, tokens->value + old_tail, (Size_t)tokens->tail * sizeof(*tokens->value));
+	}
+}
+
+void TokenBuffer_Reserve(TokenBuffer* tokens, U32 capacity) {
+	if (capacity > tokens->capacity) TokenBufferSetCapacity(tokens, capacity);
+}
+
+void TokenBuffer_Grow(TokenBuffer* tokens) {
+	TokenBufferSetCapacity(tokens, tokens->capacity * 2);
+}
+
+/*
+	Tokens crossing the gap change sides, so their starts gain or lose the
+	pending shift. Moving back toward the head copies forward and moving into
+	the tail copies backward, either way the copy never reads a slot it wrote.
+*/
+void TokenBuffer_MoveGap(TokenBuffer* tokens, U32 index) {
+	U32 head = tokens->count - tokens->tail;
+	U32 gap = tokens->capacity - tokens->count;
+
+	if (index < head) {
+		U32 moved = head - index;
+		Memmove(tokens->kind + index + gap, tokens->kind + index, (Size_t)moved * sizeof(*tokens->kind));
+		Memmove(tokens->length + index + gap, tokens->length + index, (Size_t)moved * sizeof(*tokens->length));
+		Memmove(tokens->value + index + gap, tokens->value + index, (Size_t)moved * sizeof(*tokens->value));
+		for (U32 i = moved; i-- > 0;) tokens->start[index + gap + i] = tokens->start[index + i] - tokens->tail_shift;
+		tokens->tail += moved;
+	}
+	else if (index > head) {
+		U32 moved = index - head;
+		Memmove(tokens->kind + head, tokens->kind + head + gap, (Size_t)moved * sizeof(*tokens->kind));
+		Memmove(tokens->length + head, tokens->length + head + gap, (Size_t)moved * sizeof(*tokens->length));
+		Memmove(tokens->value + head, tokens->value + head + gap, (Size_t)moved * sizeof(*tokens->value));
+		for (U32 i = 0; i < moved; i++) tokens->start[head + i] = tokens->start[head + gap + i] + tokens->tail_shift;
+		tokens->tail -= moved;
+	}
+	if (tokens->tail == 0) tokens->tail_shift = 0;
+}
+
+Token TokenBuffer_Get(const TokenBuffer* tokens, U32 index) {
+	U32 slot = TokenBuffer_Slot(tokens, index);
+	return (Token) {
+		.kind = tokens->kind[slot],
+		.start = TokenBuffer_GetStart(tokens, index),
+		.length = tokens->length[slot],
+		.value = tokens->value[slot]
+	};
+}
+
+void TokenBuffer_Free(TokenBuffer* tokens) {
+	if (tokens == NULL) return;
+	Free(tokens->kind);
+	Free(tokens->start);
+	Free(tokens->length);
+	Free(tokens->value);
+	Free(tokens);
+}
+
+static const StrView TokenKindPrintTable[TOKEN_COUNT] = {
+	[TOKEN_NONE] = STRVIEW_INIT("None"),
+	[TOKEN_LEFT_PAREN] = STRVIEW_INIT("LEFT_PAREN"),
+	[TOKEN_RIGHT_PAREN] = STRVIEW_INIT("RIGHT_PAREN"),
+	[TOKEN_LEFT_BRACE] = STRVIEW_INIT("LEFT_BRACE"),
+	[TOKEN_RIGHT_BRACE] = STRVIEW_INIT("RIGHT_BRACE"),
+	[TOKEN_MUL] = STRVIEW_INIT("MUL"),
+	[TOKEN_DIV] = STRVIEW_INIT("DIV"),
+	[TOKEN_PLUS] = STRVIEW_INIT("PLUS"),
+	[TOKEN_MINUS] = STRVIEW_INIT("MINUS"),
+	[TOKEN_LITERAL] = STRVIEW_INIT("LITERAL"),
+	[TOKEN_NUMERIC] = STRVIEW_INIT("NUMERIC"),
+	[TOKEN_FLOAT] = STRVIEW_INIT("FLOAT"),
+	[TOKEN_SEMICOLON] = STRVIEW_INIT("SEMICOLON"),
+	[TOKEN_COLON] = STRVIEW_INIT("COLON"),
+	[TOKEN_COMMA] = STRVIEW_INIT("COMMA"),
+	[TOKEN_LESS_THAN] = STRVIEW_INIT("LESS_THAN"),
+	[TOKEN_GREATER_THAN] = STRVIEW_INIT("GREATER_THAN"),
+	[TOKEN_EQUAL] = STRVIEW_INIT("EQUAL"),
+	[TOKEN_AT] = STRVIEW_INIT("AT"),
+	[TOKEN_EQUAL_EQUAL] = STRVIEW_INIT("EQUAL_EQUAL"),
+	[TOKEN_BANG_EQUAL] = STRVIEW_INIT("BANG_EQUAL"),
+	[TOKEN_LESS_EQUAL] = STRVIEW_INIT("LESS_EQUAL"),
+	[TOKEN_GREATER_EQUAL] = STRVIEW_INIT("GREATER_EQUAL"),
+	[TOKEN_ARROW] = STRVIEW_INIT("ARROW"),
+
+	[TOKEN_IDENTIFIER] = STRVIEW_INIT("IDENTIFIER"),
+	[TOKEN_FUNC] = STRVIEW_INIT("FUNC"),
+	[TOKEN_FOR] = STRVIEW_INIT("FOR"),
+	[TOKEN_WHILE] = STRVIEW_INIT("WHILE"),
+	[TOKEN_IF] = STRVIEW_INIT("IF"),
+	[TOKEN_ELSE] = STRVIEW_INIT("ELSE"),
+
+	[TOKEN_STRING] = STRVIEW_INIT("STRING"),
+	[TOKEN_CHAR] = STRVIEW_INIT("CHAR"),
+
+	[TOKEN_ILLEGAL] = STRVIEW_INIT("ILLEGAL"),
+	[TOKEN_ERROR] = STRVIEW_INIT("ERROR"),
+	[TOKEN_EOF] = STRVIEW_INIT("EOF"),
+};
+
+StrView TokenKindToString(TokenKind kind) {
+	return TokenKindPrintTable[kind];
+}
+
+void TokenBuffer_Print(const TokenBuffer* tokens, Output* out) {
+	/* kind names carry their lengths, the loop is plain copies */
+	for (U32 i = 0; i < tokens->count; i++) {
+		U8 kind = tokens->kind[TokenBuffer_Slot(tokens, i)];
+		Output_WriteStrView(out, STRVIEW("{ Kind: "));
+		Output_WriteStrView(out, TokenKindPrintTable[kind]);
+		Output_WriteStrView(out, STRVIEW(", Value: "));
+		Output_WriteStrView(out, TokenBuffer_GetText(tokens, i));
+		Output_WriteStrView(out, STRVIEW(" }\n"));
+	}
+}
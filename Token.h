@@ -0,0 +1,130 @@
+#pragma once
+#include "Common.h"
+#include "String.h"
+#include "Output.h"
+
+typedef enum {
+	TOKEN_NONE,
+	TOKEN_LEFT_PAREN,
+	TOKEN_RIGHT_PAREN,
+	TOKEN_LEFT_BRACE,
+	TOKEN_RIGHT_BRACE,
+	TOKEN_MUL,
+	TOKEN_DIV,
+	TOKEN_PLUS,
+	TOKEN_MINUS,
+	TOKEN_LITERAL,
+	TOKEN_NUMERIC,
+	TOKEN_FLOAT,
+	TOKEN_SEMICOLON,
+	TOKEN_COLON,
+	TOKEN_COMMA,
+	TOKEN_LESS_THAN,
+	TOKEN_GREATER_THAN,
+	TOKEN_EQUAL,
+	TOKEN_AT,
+	TOKEN_EQUAL_EQUAL,
+	TOKEN_BANG_EQUAL,
+	TOKEN_LESS_EQUAL,
+	TOKEN_GREATER_EQUAL,
+	TOKEN_ARROW,
+
+	TOKEN_IDENTIFIER,
+	TOKEN_FUNC,
+	TOKEN_FOR,
+	TOKEN_WHILE,
+	TOKEN_IF,
+	TOKEN_ELSE,
+
+	TOKEN_STRING,
+	TOKEN_CHAR,
+
+	TOKEN_ILLEGAL,
+	TOKEN_ERROR,
+	TOKEN_EOF,
+	TOKEN_COUNT
+} TokenKind;
+
+/*
+	A single token as produced by the scanner, its text is source[start, start + length).
+	value depends on the kind: the interned symbol id for identifiers, the
+	index of the decoded value in the interner's constants for numbers, the
+	character for char literals, the ScannerError for ILLEGAL, 0 otherwise.
+*/
+typedef struct token_t {
+	TokenKind kind;
+	U32 start;
+	U32 length;
+	U32 value;
+} Token;
+
+/*
+	Token stream stored as struct-of-arrays, 13 bytes per token.
+	Tokens don't own their text, they are spans into the source buffer,
+	which therefore has to outlive the token buffer.
+
+	ScannerRelex turns it into a gap buffer: the last tail tokens live at the
+	end of the arrays, past the unused slots, and their stored starts are
+	missing tail_shift. The arrays can only be indexed directly while tail is 0,
+	otherwise go through the accessors below or close the gap first.
+*/
+typedef struct tokenbuffer_t {
+	U8*  kind;              // TokenKind, fits in a byte
+	U32* start;             // byte offset into source
+	U32* length;
+	U32* value;
+	U32 count;
+	U32 capacity;
+	U32 tail;               // tokens stored after the gap
+	U32 tail_shift;         // still to be added to their starts, modulo 2^32
+	const U8* source;
+} TokenBuffer;
+
+/* Sources average a few bytes per token, sizing from the length avoids most regrowth */
+#define TOKEN_BYTES_PER_TOKEN_ESTIMATE 4
+U32 TokenBuffer_EstimateCapacity(Size_t source_size);
+
+TokenBuffer* TokenBuffer_Create(U32 capacity, const U8* source);
+void TokenBuffer_Reserve(TokenBuffer* tokens, U32 capacity);
+/* Doubles the capacity, the slow path of TokenBuffer_Push */
+void TokenBuffer_Grow(TokenBuffer* tokens);
+/* Moves the gap to just before token index, costs the distance it moves */
+void TokenBuffer_MoveGap(TokenBuffer* tokens, U32 index);
+/* Makes the arrays flat again */
+static inline void TokenBuffer_CloseGap(TokenBuffer* tokens) {
+	if (tokens->tail != 0) TokenBuffer_MoveGap(tokens, tokens->count);
+}
+
+/* Where token index is stored in the arrays */
+static inline U32 TokenBuffer_Slot(const TokenBuffer* tokens, U32 index) {
+	return index < tokens->count - tokens->tail ? index : index + (tokens->capacity - tokens->count);
+}
+
+static inline U32 TokenBuffer_GetStart(const TokenBuffer* tokens, U32 index) {
+	if (index < tokens->count - tokens->tail) return tokens->start[index];
+	return tokens->start[index + (tokens->capacity - tokens->count)] + tokens->tail_shift;
+}
+
+/* Appends after the last token, the gap must be closed */
+static inline void TokenBuffer_Push(TokenBuffer* tokens, Token token) {
+	if (tokens->capacity <= tokens->count) {
+		TokenBuffer_Grow(tokens);
+	}
+
+	U32 index = tokens->count++;
+	tokens->kind[index] = (U8)token.kind;
+	tokens->start[index] = token.start;
+	tokens->length[index] = token.length;
+	tokens->value[index] = token.value;
+}
+Token TokenBuffer_Get(const TokenBuffer* tokens, U32 index);
+
+/* The source bytes the token spans */
+static inline StrView TokenBuffer_GetText(const TokenBuffer* tokens, U32 index) {
+	return StrView_Make(tokens->source + TokenBuffer_GetStart(tokens, index), tokens->length[TokenBuffer_Slot(tokens, index)]);
+}
+
+void TokenBuffer_Print(const TokenBuffer* tokens, Output* out);
+void TokenBuffer_Free(TokenBuffer* tokens);
+
+StrView TokenKindToString(TokenKind kind);
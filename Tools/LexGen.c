@@ -0,0 +1,189 @@
+/*
+	Compiles the token spec (SCANNER_OPERATOR_LIST in ScannerSpec.h and
+	KEYWORD_LIST in Keyword.h) into the DFA tables of ScannerTables.h:
+
+		cc -I. -o lexgen Tools/LexGen.c && ./lexgen > ScannerTables.h
+
+	Rerun it after changing either list. It has to work before there is a
+	compiler to link against, so it only takes macros and the TokenKind enum
+	from the tree and does its own I/O with stdio.
+*/
+#include "ScannerSpec.h"
+#include "Keyword.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LEXGEN_MAX_STATES 256       // state ids are emitted as U8
+#define LEXGEN_DEAD       0
+#define LEXGEN_START      1
+
+typedef struct lexstate_t {
+	U32 next[256];
+	const char* accept;             // TokenKind the state completes, NULL if it doesn't complete one
+} LexState;
+
+typedef struct lexspelling_t {
+	const char* kind;
+	const char* spelling;
+} LexSpelling;
+
+#define LEXGEN_SPELLING(kind, spelling) { #kind, spelling },
+#define LEXGEN_KEYWORD(kind, spelling, first, last) { #kind, spelling },
+
+static const LexSpelling LexOperators[] = {
+	SCANNER_OPERATOR_LIST(LEXGEN_SPELLING)
+};
+
+static const LexSpelling LexKeywords[] = {
+	KEYWORD_LIST(LEXGEN_KEYWORD)
+};
+
+#define LEXGEN_COUNT(array) (sizeof(array) / sizeof((array)[0]))
+
+static LexState g_states[LEXGEN_MAX_STATES];
+static U32 g_stateCount;
+static U32 g_identifierState;
+
+static void Fail(const char* message, const char* detail) {
+	fprintf(stderr, "lexgen: %s %s\n", message, detail);
+	exit(1);
+}
+
+static Bool IsLetter(U32 c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static Bool IsDigit(U32 c) {
+	return c >= '0' && c <= '9';
+}
+
+static U32 AddState(const char* accept) {
+	if (g_stateCount == LEXGEN_MAX_STATES) Fail("too many states for U8 ids", "");
+	U32 state = g_stateCount++;
+	for (U32 c = 0; c < 256; c++) g_states[state].next[c] = LEXGEN_DEAD;
+	g_states[state].accept = accept;
+	return state;
+}
+
+/* Identifiers and numbers are runs of one character class */
+static void AddRuns(void) {
+	g_identifierState = AddState("TOKEN_IDENTIFIER");
+	U32 number = AddState("TOKEN_NUMERIC");
+
+	for (U32 c = 0; c < 256; c++) {
+		if (IsLetter(c)) {
+			g_states[LEXGEN_START].next[c] = g_identifierState;
+			g_states[g_identifierState].next[c] = g_identifierState;
+		}
+		if (IsDigit(c)) {
+			g_states[LEXGEN_START].next[c] = number;
+			g_states[number].next[c] = number;
+		}
+	}
+}
+
+/*
+	Keywords become a trie carved out of the identifier state. Every trie state
+	is still an identifier, letters that leave the trie fall back to the plain
+	identifier run, so "fun" and "funcs" scan as identifiers and "func" as FUNC.
+*/
+static void AddKeyword(const LexSpelling* keyword) {
+	U32 state = LEXGEN_START;
+	for (const char* c = keyword->spelling; *c != '\0'; c++) {
+		U8 byte = (U8)*c;
+		if (!IsLetter(byte)) Fail("keyword with a non-letter:", keyword->spelling);
+
+		U32 next = g_states[state].next[byte];
+		if (next == g_identifierState) {
+			next = AddState("TOKEN_IDENTIFIER");
+			g_states[next] = g_states[g_identifierState];
+			g_states[state].next[byte] = next;
+		}
+		state = next;
+	}
+
+	if (strcmp(g_states[state].accept, "TOKEN_IDENTIFIER") != 0) Fail("duplicate keyword", keyword->spelling);
+	g_states[state].accept = keyword->kind;
+}
+
+/* Operators are a trie of their own, a prefix that isn't an operator itself accepts nothing */
+static void AddOperator(const LexSpelling* op) {
+	U32 state = LEXGEN_START;
+	for (const char* c = op->spelling; *c != '\0'; c++) {
+		U8 byte = (U8)*c;
+		if (IsLetter(byte) || IsDigit(byte)) Fail("operator with a letter or digit:", op->spelling);
+
+		U32 next = g_states[state].next[byte];
+		if (next == LEXGEN_DEAD) {
+			next = AddState(NULL);
+			g_states[state].next[byte] = next;
+		}
+		state = next;
+	}
+
+	if (g_states[state].accept != NULL) Fail("duplicate operator", op->spelling);
+	g_states[state].accept = op->kind;
+}
+
+static Bool SameColumn(U32 first, U32 second) {
+	for (U32 state = 0; state < g_stateCount; state++) {
+		if (g_states[state].next[first] != g_states[state].next[second]) return FALSE;
+	}
+	return TRUE;
+}
+
+int main(void) {
+	AddState(NULL);     // LEXGEN_DEAD
+	AddState(NULL);     // LEXGEN_START
+	AddRuns();
+	for (U32 i = 0; i < LEXGEN_COUNT(LexKeywords); i++) AddKeyword(&LexKeywords[i]);
+	for (U32 i = 0; i < LEXGEN_COUNT(LexOperators); i++) AddOperator(&LexOperators[i]);
+
+	/* bytes no state tells apart share a column */
+	U32 classes[256];
+	U32 representatives[256];
+	U32 class_count = 0;
+	for (U32 c = 0; c < 256; c++) {
+		U32 k = 0;
+		while (k < class_count && !SameColumn(representatives[k], c)) k++;
+		if (k == class_count) representatives[class_count++] = c;
+		classes[c] = k;
+	}
+
+	printf("/* Generated by Tools/LexGen.c from ScannerSpec.h and Keyword.h, don't edit by hand */\n");
+	printf("#pragma once\n");
+	printf("#include \"Token.h\"\n\n");
+	printf("#define SCANNER_DFA_DEAD        %u\n", LEXGEN_DEAD);
+	printf("#define SCANNER_DFA_START       %u\n", LEXGEN_START);
+	printf("#define SCANNER_DFA_STATE_COUNT %u\n", g_stateCount);
+	printf("#define SCANNER_DFA_CLASS_COUNT %u\n\n", class_count);
+
+	printf("/* Byte -> equivalence class */\n");
+	printf("static const U8 ScannerDfaClass[256] = {\n");
+	for (U32 c = 0; c < 256; c++) {
+		if (c % 16 == 0) printf("\t");
+		printf("%2u,%s", classes[c], c % 16 == 15 ? "\n" : " ");
+	}
+	printf("};\n\n");
+
+	printf("/* [state][class] -> next state, SCANNER_DFA_DEAD ends the token */\n");
+	printf("static const U8 ScannerDfaNext[SCANNER_DFA_STATE_COUNT][SCANNER_DFA_CLASS_COUNT] = {\n");
+	for (U32 state = 0; state < g_stateCount; state++) {
+		printf("\t{");
+		for (U32 k = 0; k < class_count; k++) {
+			printf("%s%2u", k == 0 ? "" : ", ", g_states[state].next[representatives[k]]);
+		}
+		printf("},\n");
+	}
+	printf("};\n\n");
+
+	printf("/* Token produced by a match that ends in the state, TOKEN_NONE if it isn't a whole token */\n");
+	printf("static const U8 ScannerDfaAccept[SCANNER_DFA_STATE_COUNT] = {\n");
+	for (U32 state = 0; state < g_stateCount; state++) {
+		printf("\t%s,\n", g_states[state].accept ? g_states[state].accept : "TOKEN_NONE");
+	}
+	printf("};\n");
+	return 0;
+}
@@ -7,8 +7,8 @@ typedef unsigned char      U8;
 typedef short              S16;
 typedef unsigned short     U16;
 
-typedef long               S32;
-typedef unsigned long      U32;
+typedef int                S32;
+typedef unsigned int       U32;
 
 #if defined(__GNUC__) || defined(_MSC_VER)
 typedef signed long long   S64;
@@ -21,4 +21,12 @@ typedef U64 Size_t;
 typedef U32 Size_t;
 #endif
 
-typedef U8 Bool;
\ No newline at end of file
+typedef U8 Bool;
+
+#ifndef TRUE
+#define TRUE  1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+#include "Common.h"
+#include "Memory.h"
+#include "Logger.h"
+
+/*
+	Typed growable arrays.
+
+	DEFINE_VEC(Token) defines TokenVec with TokenVec_Push, _Reserve, _Append and
+	friends. Elements are stored inline and copied with their static size, the
+	only out-of-line code is the grow path. DEFINE_VEC_NAMED(PathVec, const char*)
+	is for element types that aren't a single identifier.
+
+	A vector set up with _InitArena takes its storage from the arena: growing
+	leaves the old storage behind until the arena is reset and _Free and
+	_ShrinkToFit do nothing.
+*/
+#define VEC_MIN_CAPACITY 8
+
+#define DEFINE_VEC(T) DEFINE_VEC_NAMED(T##Vec, T)
+
+#define DEFINE_VEC_NAMED(Name, T)                                                       \
+typedef struct {                                                                        \
+	T* data;                                                                            \
+	U32 count;                                                                          \
+	U32 capacity;                                                                       \
+	Arena* arena;           /* NULL for heap storage */                                 \
+} Name;                                                                                 \
+                                                                                        \
+static inline void Name##_Init(Name* vec) {                                             \
+	vec->data = NULL;                                                                   \
+	vec->count = 0;                                                                     \
+	vec->capacity = 0;                                                                  \
+	vec->arena = NULL;                                                                  \
+}                                                                                       \
+                                                                                        \
+static inline void Name##_InitArena(Name* vec, Arena* arena) {                          \
+	Name##_Init(vec);                                                                   \
+	vec->arena = arena;                                                                 \
+}                                                                                       \
+                                                                                        \
+/* Sets the capacity to exactly capacity, which must be >= count */                    \
+static inline void Name##_SetCapacity(Name* vec, U32 capacity) {                               \
+	T* data;                                                                            \
+	if (vec->arena != NULL) {                                                           \
+		data = ARENA_PUSH_ARRAY(vec->arena, T, capacity);                               \
+		if (data != NULL && vec->count != 0) Memcpy(data, vec->data, (Size_t)vec->count * sizeof(T)); \
+	}                                                                                   \
+	else if (capacity == 0) {                                                           \
+		Free(vec->data);                                                                \
+		data = NULL;                                                                    \
+	}                                                                                   \
+	else {                                                                              \
+		data = vec->data ? Realloc(vec->data, (Size_t)capacity * sizeof(T))             \
+		                 : Malloc((Size_t)capacity * sizeof(T));                        \
+	}                                                                                   \
+	if (data == NULL && capacity != 0) {                                                \
+		PANIC("Couldn't grow " #Name);                                                  \
+	}                                                                                   \
+	vec->data = data;                                                                   \
+	vec->capacity = capacity;                                                           \
+}                                                                                       \
+                                                                                        \
+static inline void Name##_Reserve(Name* vec, U32 capacity) {                            \
+	if (capacity > vec->capacity) Name##_SetCapacity(vec, capacity);                    \
+}                                                                                       \
+                                                                                        \
+/* Geometric growth so pushes stay amortized O(1) */                                   \
+static inline void Name##_Grow(Name* vec, U32 required) {                                      \
+	U32 capacity = vec->capacity ? vec->capacity : VEC_MIN_CAPACITY;                    \
+	while (capacity < required) capacity += capacity / 2 + VEC_MIN_CAPACITY;            \
+	Name##_SetCapacity(vec, capacity);                                                  \
+}                                                                                       \
+                                                                                        \
+static inline T* Name##_Push(Name* vec, T value) {                                      \
+	if (vec->count == vec->capacity) Name##_Grow(vec, vec->count + 1);                  \
+	T* slot = &vec->data[vec->count++];                                                 \
+	*slot = value;                                                                      \
+	return slot;                                                                        \
+}                                                                                       \
+                                                                                        \
+static inline void Name##_Append(Name* vec, const T* values, U32 count) {               \
+	if (count == 0) return;                                                             \
+	if (vec->count + count > vec->capacity) Name##_Grow(vec, vec->count + count);       \
+	Memcpy(vec->data + vec->count, values, (Size_t)count * sizeof(T));                  \
+	vec->count += count;                                                                \
+}                                                                                       \
+                                                                                        \
+static inline void Name##_ShrinkToFit(Name* vec) {                                      \
+	if (vec->arena == NULL && vec->capacity != vec->count) Name##_SetCapacity(vec, vec->count); \
+}                                                                                       \
+                                                                                        \
+static inline void Name##_Clear(Name* vec) {                                            \
+	vec->count = 0;                                                                     \
+}                                                                                       \
+                                                                                        \
+static inline void Name##_Free(Name* vec) {                                             \
+	if (vec->arena == NULL) Free(vec->data);                                            \
+	vec->data = NULL;                                                                   \
+	vec->count = 0;                                                                     \
+	vec->capacity = 0;                                                                  \
+}